@@ -8,6 +8,27 @@
   - display.h: Display functions and UI
   - controls.h: Button and joystick handling  
   - radio.h: NRF24 communication
+  - hopping.h: Frequency hopping table and receiver timing contract
+  - tdma.h: Time-slotted transmission to several receivers
+  - rc_packet.h: Packed multi-channel packet format
+  - redundancy.h: Delta / parity frames for rebuilding lost frames
+  - subframes.h: Critical channels every frame, aux channels round robin
+  - radio_health.h: Chip checks and automatic re-initialisation
+  - fast_disarm.h: Interrupt-level disarm with a neutral frame burst
+  - ppm_output.h: Timer1 PPM output for trainer ports / external modules
+  - serial_output.h: SBUS / CRSF output on Serial1 for external RF modules
+  - serial_trainer.h: Channel input from a PC and '#' console commands
+  - control_isr.h: Optional Timer3 interrupt control path and the UI snapshot
+  - frame_sync.h: Receiver frame-phase alignment
+  - link_adapt.h: Closed-loop PA level, data rate and retry adaptation
+  - link_stats.h: Rolling link-quality statistics
+  - scanner.h: 2.4 GHz spectrum scanner
+  - bind.h: Bind handshake with the receiver
+  - ping.h: Over-the-air round-trip latency test
+  - radio_test.h: Throughput / packet error rate benchmark
+  - scheduler.h: Deadline-based task scheduler for loop()
+  - profiler.h: Per-section timing histograms
+  - trace.h: Event trace ring buffer for the serial console
   - config.h: Pin definitions and constants
   
   New Features:
@@ -21,15 +42,23 @@
 */
 
 #include "config.h"
+#include "profiler.h"
+#include "trace.h"
 #include "radio.h"
+#include "radio_health.h"
+#include "fast_disarm.h"
+#include "ppm_output.h"
+#include "serial_output.h"
 #include "display.h" 
 #include "controls.h"
+#include "serial_trainer.h"
+#include "control_isr.h"
 #include "menu.h"
+#include "scheduler.h"
 
 // Global variables
 RCData data;
-unsigned long lastTransmit = 0;
-unsigned long lastDisplayUpdate = 0;
+int16_t channels[RC_CHANNEL_COUNT];
 
 // LED update tracking to prevent excessive calls
 unsigned long lastLEDUpdate = 0;
@@ -52,16 +81,21 @@ void setup() {
   Serial.println("2. Initializing Controls...");
   initControls();
   
-  Serial.println("3. Initializing Radio...");
+  // Menu first - it loads SettingsData, which holds the bound address and channel
+  Serial.println("3. Initializing Menu System...");
+  initMenu();
+  
+  Serial.println("4. Initializing Radio...");
   initRadio();
   
-  Serial.println("4. Initializing Menu System...");
-  initMenu();
+  // Trigger release is polled from a timer interrupt from here on
+  initFastDisarm();
   
   // Initialize data structure
   data.throttle = 0;
   data.steering = 0;
   data.counter = 0;
+  memset(channels, 0, sizeof(channels));
   
   // Show ready screen with menu instructions
   displayReady();
@@ -71,6 +105,11 @@ void setup() {
   extern void applyLEDSettings();
   applyLEDSettings();
   
+  initScheduler();
+  
+  // With CONTROL_ISR, Timer3 owns sampling and transmit from here on
+  initControlIsr();
+  
   Serial.println("=====================================");
   Serial.println("Setup Complete! Ready to transmit.");
   Serial.println("Hold OK button for 2 seconds to enter menu");
@@ -79,27 +118,102 @@ void setup() {
 }
 
 void loop() {
-  // Update menu system first (handles OK button long press)
-  updateMenu();
+  // The radio task only exists while the link runs, at the adaptive packet
+  // rate (keep-alive when idle, max rate while sticks move) - set min = max
+  // rate in Link Settings for a fixed rate. Off while the spectrum scanner
+  // or bind owns the radio, and when Output is PPM / serial only. With
+  // CONTROL_ISR the Timer3 interrupt transmits instead (control_isr.h)
+  bool linkEnabled = isRadioOutputEnabled() && !isLinkPaused();
+  setControlLinkEnabled(linkEnabled);
+  setTaskEnabled(TASK_RADIO, !CONTROL_ISR && linkEnabled);
+  setTaskPeriod(TASK_RADIO, getTransmitInterval());
+  // Console dumps (status, #trace) run as their own task until sent
+  setTaskEnabled(TASK_CONSOLE, isConsoleBusy());
   
-  // Read controls (includes calibrated joystick values)
-  readJoysticks();
+  // Runs every task that is due, in priority order (see scheduler.h)
+  PROF_BEGIN(PROF_LOOP);
+  runScheduler();
+  PROF_END(PROF_LOOP);
+  PROF_COUNT_LOOP();
+}
+
+// Radio sections are bracketed so the fast disarm ISR never interrupts
+// an SPI transfer - outside them it sends its burst at once
+
+void taskInput() {
+  // Check buttons (includes arming system)
+  PROF_BEGIN(PROF_BUTTONS);
+  checkButtons();
+  PROF_END(PROF_BUTTONS);
   
-  // Transmit data every 20ms (50Hz) - only if not in active calibration
-  if (millis() - lastTransmit >= TRANSMIT_INTERVAL) {
-    transmitData();
-    lastTransmit = millis();
+  // Read controls (includes calibrated joystick values) - channel frames
+  // from a PC replace them while they keep arriving
+  updateSerialTrainer();
+#if !CONTROL_ISR
+  PROF_BEGIN(PROF_JOYSTICKS);
+  if (isTrainerActive()) {
+    applyTrainerInput();
+  } else {
+    readJoysticks();
   }
+  PROF_END(PROF_JOYSTICKS);
   
-  // Update display every 50ms (20Hz)
-  if (millis() - lastDisplayUpdate >= DISPLAY_INTERVAL) {
-    updateDisplay(); // Automatically switches between main and menu display
-    lastDisplayUpdate = millis();
-  }
+  // Pick the packet rate from stick motion - checked every pass so a stick
+  // movement is not held back by a long keep-alive interval
+  updatePacketRate();
+#endif
   
-  // Check buttons (includes arming system)
-  checkButtons();
+  // Display and outputs read the control values through the snapshot
+  refreshUiSnapshot();
+  
+  // PPM output takes the new channel values at its next frame (Timer1 ISR)
+  updatePPM();
   
+  // SBUS / CRSF frames go to the Serial1 TX buffer at the protocol rate - never waits on the UART
+  updateSerialOutput();
+}
+
+void taskRadio() {
+  beginRadioUse();
+  PROF_BEGIN(PROF_TRANSMIT);
+  transmitData();
+  PROF_END(PROF_TRANSMIT);
+  endRadioUse();
+  // Frame sync moves the schedule so frames land just before the receiver output update
+  shiftTask(TASK_RADIO, takeFrameSyncShift(data.counter + 1));
+}
+
+void taskHealth() {
+  // Re-initialise the radio if it stopped answering (bounded, see radio_health.h)
+  beginRadioUse();
+  updateRadioHealth();
+  endRadioUse();
+}
+
+void taskMenu() {
+  // Handles the OK button long press - menu tools bracket their own radio use
+  PROF_BEGIN(PROF_MENU);
+  updateMenu();
+  PROF_END(PROF_MENU);
+}
+
+void taskDisplay() {
+  // Draw at 20Hz into the buffer, once the previous frame is on the panel
+  if (isDisplayPushPending()) return;
+  PROF_BEGIN(PROF_DISPLAY);
+  updateDisplay(); // Automatically switches between main and menu display
+  PROF_END(PROF_DISPLAY);
+  setTaskEnabled(TASK_DISPLAY_PUSH, true);
+}
+
+void taskDisplayPush() {
+  PROF_BEGIN(PROF_DISPLAY_PUSH);
+  bool more = pushDisplayChunk();
+  PROF_END(PROF_DISPLAY_PUSH);
+  if (!more) setTaskEnabled(TASK_DISPLAY_PUSH, false);
+}
+
+void taskLEDs() {
   // CRITICAL FIX: Only update LEDs when state actually changes
   // This prevents other modules from overriding LED settings
   bool currentArmedState = getArmedStatus();
@@ -116,34 +230,198 @@ void loop() {
     lastArmedState = currentArmedState;
     lastMenuState = currentMenuState;
   }
-  
-  // Optional debug output
-  static unsigned long lastDebug = 0;
-  if (millis() - lastDebug > 10000) { // Every 10 seconds (reduced frequency)
-    printSystemStatus();
-    lastDebug = millis();
-  }
 }
 
-void printSystemStatus() {
-  Serial.println("--- System Status ---");
-  Serial.print("Armed: "); Serial.println(getArmedStatus() ? "YES" : "NO");
-  Serial.print("Radio: "); Serial.println(isRadioOK() ? "OK" : "FAILED");
-  Serial.print("Menu Active: "); Serial.println(isMenuActive() ? "YES" : "NO");
-  Serial.print("Throttle: "); Serial.print(data.throttle); 
-  Serial.print(" Steering: "); Serial.println(data.steering);
-  Serial.print("Packets sent: "); Serial.println(data.counter);
-  
-  // LED status debug
-  extern SettingsData settings;
-  Serial.print("LED Enabled: "); Serial.println(settings.ledEnabled ? "YES" : "NO");
-  Serial.print("Armed Color: R:");
-  Serial.print(settings.ledArmedColor[0] ? "1" : "0");
-  Serial.print(" G:");
-  Serial.print(settings.ledArmedColor[1] ? "1" : "0");
-  Serial.print(" B:");
-  Serial.println(settings.ledArmedColor[2] ? "1" : "0");
-  
-  Serial.println("Hold OK for menu, Left trigger to arm");
-  Serial.println("--------------------");
+void taskDebug() {
+  // Optional debug output every 10 seconds (reduced frequency) - sent a
+  // section at a time by taskConsole(), skipped while another dump runs
+  startConsoleDump(printStatusSection);
+}
+
+void taskConsole() {
+  // Console dumps go out as the Serial TX buffer drains, never waiting on it
+  updateConsole();
+}
+
+// Status dump sections - one or a few short lines each
+enum StatusSection {
+  STATUS_ARMED,
+  STATUS_RADIO,
+  STATUS_TRAINER,
+  STATUS_SCHEDULE,
+  STATUS_CONTROLS,
+  STATUS_CONTROL_ISR,
+  STATUS_PACKET_RATE,
+  STATUS_LINK,
+  STATUS_AIRTIME,
+  STATUS_SERIAL_OUT,
+  STATUS_SUBFRAMES,
+  STATUS_DROP_TEST,
+  STATUS_CHANNEL,
+  STATUS_SLOTS,
+  STATUS_ADAPT = STATUS_SLOTS + TDMA_MAX_SLOTS,
+  STATUS_RECONFIG,
+  STATUS_TELEMETRY,
+  STATUS_FRAME_SYNC,
+  STATUS_LEDS,
+  STATUS_FOOTER,
+  STATUS_SECTIONS
+};
+
+bool printStatusSection(Print &out, uint16_t section) {
+  // Returns false once every section has been printed
+  if (section >= STATUS_SECTIONS) return false;
+  
+  if (section >= STATUS_SLOTS && section < STATUS_SLOTS + TDMA_MAX_SLOTS) {
+    uint8_t i = section - STATUS_SLOTS;
+    if (isTdmaEnabled() && i < getTdmaSlots()) {
+      out.print("Slot "); out.print(i); out.print(" ("); out.print(getTdmaMixName(getTdmaMix(i)));
+      out.print("): "); out.print(slotStats[i].rate); out.print(" Hz, worst ");
+      out.print(slotStats[i].worstInterval); out.print(" us, jitter ");
+      out.print(slotStats[i].jitter); out.print(" us, skipped ");
+      out.println(slotStats[i].skipped);
+    }
+    return true;
+  }
+  
+  switch (section) {
+    case STATUS_ARMED:
+      out.println("--- System Status ---");
+      out.print("Armed: "); out.print(getArmedStatus() ? "YES" : "NO");
+      out.print(" (fast disarms "); out.print(fastDisarmCount);
+      out.print(", deferred "); out.print(deferredDisarmCount);
+      out.print(", last "); out.print(lastDisarmLatency);
+      out.print(" us, worst "); out.print(worstDisarmLatency); out.println(" us)");
+      break;
+    case STATUS_RADIO:
+      out.print("Radio: "); out.print(isRadioOK() ? "OK" : "FAILED");
+      out.print(" (faults "); out.print(linkStats.radioFaults);
+      out.print(", recovered "); out.print(linkStats.radioRecoveries);
+      out.print(", last "); out.print(linkStats.lastRecoveryTime);
+      out.print(" ms, worst "); out.print(linkStats.worstRecoveryTime); out.println(" ms)");
+      break;
+    case STATUS_TRAINER:
+      if (trainerFrames > 0) printTrainerStats(out);
+      break;
+    case STATUS_SCHEDULE:
+      out.print("Radio schedule: worst late "); out.print(tasks[TASK_RADIO].worstLate);
+      out.print(" us, "); out.print(tasks[TASK_RADIO].overruns); out.println(" overruns (#sched for all tasks)");
+      break;
+    case STATUS_CONTROLS:
+      out.print("Menu Active: "); out.println(isMenuActive() ? "YES" : "NO");
+      out.print("Throttle: "); out.print(uiSnapshot.data.throttle); 
+      out.print(" Steering: "); out.println(uiSnapshot.data.steering);
+      out.print("Packets sent: "); out.println(uiSnapshot.data.counter);
+      break;
+    case STATUS_CONTROL_ISR:
+#if CONTROL_ISR
+      out.print("Control ISR: "); out.print(controlIsrTicks); out.print(" ticks, ");
+      out.print(lastControlIsrMicros); out.print("/"); out.print(worstControlIsrMicros);
+      out.print(" us (last/worst), jitter "); out.print(worstControlJitter);
+      out.print(" us, "); out.print(controlIsrBusySkips); out.print(" busy, ");
+      out.print(controlIsrOverlaps); out.println(" overlaps");
+#endif
+      break;
+    case STATUS_PACKET_RATE:
+      out.print("Packet rate: "); out.print(getCurrentPacketRate()); out.print(" Hz (effective ");
+      out.print(linkStats.effectiveRate); out.println(" Hz)");
+      break;
+    case STATUS_LINK:
+      out.print("Link: loss "); out.print(getLinkLossPercent());
+      out.print("% ("); out.print(linkStats.framesLost); out.print(" lost, ");
+      out.print(linkStats.framesSkipped); out.print(" skipped), retries/s ");
+      out.print(linkStats.retriesPerSecond); out.print(", worst gap ");
+      out.print(linkStats.worstGap); out.print("/"); out.print(linkStats.worstGapEver);
+      out.println(" us");
+      break;
+    case STATUS_AIRTIME:
+      out.print("Airtime: "); out.print(linkStats.airtimePermille / 10.0, 1);
+      out.print("% (redundancy "); out.print(linkStats.redundantPermille / 10.0, 1);
+      out.print("%), "); out.print(linkStats.bytesSent); out.print(" bytes, ");
+      out.print(linkStats.redundantBytes); out.println(" redundant");
+      break;
+    case STATUS_SERIAL_OUT:
+      if (serialOutProtocol) {
+        out.print(getSerialProtocolName()); out.print(" out: "); out.print(serialFramesSent);
+        out.print(" frames, "); out.print(serialFramesSkipped); out.print(" skipped, encode ");
+        out.print(lastSerialEncodeMicros); out.print("/"); out.print(getSerialEncodeAverage());
+        out.print("/"); out.print(worstSerialEncodeMicros); out.print(" us (last/avg/worst), bench ");
+        out.print(serialBenchMicrosX10 / 10.0, 1); out.println(" us");
+      }
+      break;
+    case STATUS_SUBFRAMES:
+#if RADIO_SUBFRAMES
+      out.print("Subframes: "); out.print(isSubframeActive() ? "on" : "off (rate)");
+      out.print(", "); out.print(subframesSent); out.print(" sent, aux refresh ");
+      out.print(getAuxRefreshMillis()); out.println(" ms");
+#endif
+      break;
+    case STATUS_DROP_TEST:
+#if RADIO_TEST_DROP_PERCENT > 0
+      out.print("Drop test: "); out.print(testDropped); out.print("/"); out.print(testFrames);
+      out.print(" withheld, "); out.print(testRecovered); out.print(" recoverable, effective loss ");
+      out.print(getTestEffectiveLossPercent()); out.println("%");
+#endif
+      break;
+    case STATUS_CHANNEL:
+      out.print("Channel: "); out.print(getCurrentChannel());
+      if (isHoppingEnabled()) {
+        out.print(" (hopping, "); out.print(hopCount);
+        out.print(" hops, "); out.print(hopDeferredCount); out.print(" deferred)");
+      }
+      out.println();
+      break;
+    case STATUS_ADAPT:
+      if (isLinkAdaptActive()) {
+        out.print("Link adapt: step "); out.print(adaptStep);
+        out.print(", PA "); out.print(getAdaptPALevel());
+        out.print(", rate "); out.print(getAdaptDataRate());
+        out.print(", retries "); out.print(getAdaptRetries());
+        out.print(", "); out.print(adaptStepChanges); out.print(" changes, ");
+        out.print(adaptFallbacks); out.println(" fallbacks");
+      }
+      break;
+    case STATUS_RECONFIG:
+      if (reconfigCount > 0) {
+        out.print("Reconfigs: "); out.print(reconfigCount);
+        out.print(", last "); out.print(lastReconfigMicros);
+        out.print(" us, gap "); out.print(lastReconfigGap); out.println(" us");
+      }
+      break;
+    case STATUS_TELEMETRY:
+      // Receiver telemetry (only when ACK payloads are enabled)
+      if (isTelemetryFresh()) {
+        out.print("RX Battery: "); out.print(telemetry.batteryMillivolts); out.println(" mV");
+        out.print("RX Lost frames: "); out.println(telemetry.lostFrames);
+        out.print("RX Loop: "); out.print(telemetry.loopRate);
+        out.print(" Hz, max "); out.print(telemetry.loopMaxMicros); out.println(" us");
+      } else {
+        out.println("RX Telemetry: none");
+      }
+      break;
+    case STATUS_FRAME_SYNC:
+      if (isTelemetryFresh() && isFrameSyncActive()) {
+        out.print("Frame sync: "); out.print(isFrameSyncLocked() ? "locked" : "tracking");
+        out.print(", lead "); out.print(frameSyncLead); out.print(" us, error ");
+        out.print(frameSyncError); out.println(" us");
+      }
+      break;
+    case STATUS_LEDS: {
+      // LED status debug
+      extern SettingsData settings;
+      out.print("LED Enabled: "); out.println(settings.ledEnabled ? "YES" : "NO");
+      out.print("Armed Color: R:");
+      out.print(settings.ledArmedColor[0] ? "1" : "0");
+      out.print(" G:");
+      out.print(settings.ledArmedColor[1] ? "1" : "0");
+      out.print(" B:");
+      out.println(settings.ledArmedColor[2] ? "1" : "0");
+      break;
+    }
+    case STATUS_FOOTER:
+      out.println("Hold OK for menu, Left trigger to arm");
+      out.println("--------------------");
+      break;
+  }
+  return true;
 }
\ No newline at end of file
@@ -0,0 +1,286 @@
+/*
+  bind.h - Bind handshake with the receiver
+  RC Transmitter for Arduino Mega
+
+  Bind contract (receiver side):
+  - In bind mode the receiver listens on BIND_CHANNEL, BIND_ADDRESS at
+    1 Mbps with auto-ack, dynamic payloads and ACK payloads enabled.
+  - The transmitter repeats a BindPacket every BIND_RETRY_INTERVAL ms at
+    low power, so only a receiver close to it will hear the request.
+  - On a valid BindPacket (magic matches) the receiver stores txId, the
+    address, channel, data rate and hop parameters, then preloads a BindReply echoing
+    txId as its next ACK payload. The transmitter completes once it sees
+    that echo, so a second transmitter binding nearby cannot be confused
+    with this one.
+  - The receiver then leaves bind mode and listens on the bound address
+    and channel (or hop table) from the next power-up or immediately.
+
+  The address is derived from txId (5 characters from A-Z0-9), so two
+  transmitters in the same pond drive different addresses and each boat
+  only accepts frames from the transmitter it was bound to.
+*/
+
+#ifndef BIND_H
+#define BIND_H
+
+#include "config.h"
+#include "display.h"
+#include "radio.h"
+#include "menu_data.h"
+
+// Bind constants
+#define BIND_CHANNEL 2              // Fixed bind channel (2402 MHz)
+#define BIND_ADDRESS "BIND0"
+#define BIND_MAGIC 0xB1D0C0DEUL
+#define BIND_RETRY_INTERVAL 50      // ms between bind requests
+#define BIND_TIMEOUT 10000          // Give up after 10 seconds
+
+// Bind flags
+#define BIND_FLAG_HOPPING 0x01
+#define BIND_FLAG_PACKED 0x02
+#define BIND_FLAG_ACK_TELEMETRY 0x04
+#define BIND_FLAG_DELTA 0x08          // Frames carry the previous frame as deltas
+#define BIND_FLAG_PARITY 0x10         // Parity frame after every RADIO_PARITY_GROUP frames
+#define BIND_FLAG_SUBFRAMES 0x20      // Aux channels may arrive in rotating subframes
+
+// Bind request - MUST match receiver exactly
+struct BindPacket {
+  uint32_t magic;
+  uint32_t txId;
+  char address[5];
+  uint8_t channel;
+  uint16_t hopSeed;
+  uint8_t hopInterval;
+  uint8_t flags;
+  uint8_t dataRate;     // rf24_datarate_e for the bound link
+};
+
+// Bind confirmation returned in the ACK payload
+struct BindReply {
+  uint32_t magic;
+  uint32_t txId;
+};
+
+// Bind states
+enum BindState {
+  BIND_IDLE,
+  BIND_RUNNING,
+  BIND_SUCCESS,
+  BIND_FAILED
+};
+
+// Bind variables
+BindState bindState = BIND_IDLE;
+bool bindLastOK = false;
+unsigned long bindStartTime = 0;
+unsigned long lastBindAttempt = 0;
+uint16_t bindAttempts = 0;
+uint16_t bindAcks = 0;
+
+// External variables from menu.h
+extern MenuState currentMenu;
+extern int menuSelection;
+extern int menuOffset;
+extern int maxMenuItems;
+extern unsigned long lastNavigation;
+extern unsigned long menuTimer;
+
+// Forward declarations for external functions
+extern int getNavigationDirection();
+
+// Function declarations
+void startBind();
+void stopBind();
+void updateBind();
+bool sendBindPacket();
+void finishBind(bool success);
+void makeAddressFromTxId(uint32_t txId, char* address);
+void drawBind();
+bool isBindActive();
+bool isBinding();
+
+void startBind() {
+  if (getArmedStatus()) {
+    Serial.println("Bind blocked - disarm first");
+    return;
+  }
+
+  // Fresh address for this transmitter - the receiver learns it below
+  makeAddressFromTxId(settings.txId, settings.radioAddress);
+
+  Serial.print("Binding TX ID 0x");
+  Serial.print(settings.txId, HEX);
+  Serial.print(" address ");
+  Serial.println(settings.radioAddress);
+
+  // Bind runs on its own fixed, low-power configuration
+  discardQueuedFrames();
+  radio.setChannel(BIND_CHANNEL);
+  radio.setDataRate(RF24_1MBPS);
+  radio.setPALevel(RF24_PA_LOW);
+  radio.setAutoAck(true);
+  radio.enableDynamicPayloads();
+  radio.enableAckPayload();
+  radio.setRetries(5, 5);
+  radio.openWritingPipe((const uint8_t*)BIND_ADDRESS);
+  radio.stopListening();
+
+  bindState = BIND_RUNNING;
+  bindLastOK = buttons.btnOK; // Ignore the OK press that started the bind
+  bindStartTime = millis();
+  lastBindAttempt = 0;
+  bindAttempts = 0;
+  bindAcks = 0;
+}
+
+void stopBind() {
+  if (bindState == BIND_RUNNING) {
+    finishBind(false);
+  }
+  bindState = BIND_IDLE;
+}
+
+void updateBind() {
+  if (currentMenu != MENU_BIND) return;
+  menuTimer = millis(); // Do not auto-exit the menu on the bind screen
+
+  if (bindState == BIND_RUNNING) {
+    // The control link has priority - arming aborts the bind
+    if (getArmedStatus() || millis() - bindStartTime > BIND_TIMEOUT) {
+      finishBind(false);
+    } else if (millis() - lastBindAttempt >= BIND_RETRY_INTERVAL) {
+      lastBindAttempt = millis();
+      if (sendBindPacket()) finishBind(true);
+    }
+  }
+
+  // OK - try again once the previous attempt has finished
+  bool currentOK = buttons.btnOK;
+  if (currentOK && !bindLastOK && bindState != BIND_RUNNING) {
+    startBind();
+  }
+  bindLastOK = currentOK;
+
+  // Left - back to Link Settings
+  if (millis() - lastNavigation < NAV_DEBOUNCE) return;
+  if (getNavigationDirection() == -2) {
+    stopBind();
+    currentMenu = MENU_LINK_SETTINGS;
+    maxMenuItems = 14;
+    menuSelection = 0;
+    menuOffset = 0;
+    lastNavigation = millis();
+  }
+}
+
+bool sendBindPacket() {
+  BindPacket packet;
+  packet.magic = BIND_MAGIC;
+  packet.txId = settings.txId;
+  memcpy(packet.address, settings.radioAddress, 5);
+  packet.channel = settings.radioChannel;
+  packet.hopSeed = settings.hopSeed;
+  packet.hopInterval = settings.hopInterval;
+  packet.flags = 0;
+  if (settings.hoppingEnabled) packet.flags |= BIND_FLAG_HOPPING;
+  if (RADIO_PACKET_FORMAT == PACKET_FORMAT_PACKED) packet.flags |= BIND_FLAG_PACKED;
+  if (RADIO_ACK_TELEMETRY) packet.flags |= BIND_FLAG_ACK_TELEMETRY;
+  if (RADIO_REDUNDANCY == REDUNDANCY_DELTA) packet.flags |= BIND_FLAG_DELTA;
+  if (RADIO_REDUNDANCY == REDUNDANCY_PARITY) packet.flags |= BIND_FLAG_PARITY;
+  if (RADIO_SUBFRAMES) packet.flags |= BIND_FLAG_SUBFRAMES;
+  packet.dataRate = settings.dataRate;
+
+  bindAttempts++;
+  // Blocking write is bounded by setRetries(5, 5) to about 10 ms
+  if (!radio.write(&packet, sizeof(packet))) return false;
+  bindAcks++;
+
+  // The echo arrives in the ACK of the request after the one the receiver accepted
+  while (radio.available()) {
+    uint8_t len = radio.getDynamicPayloadSize();
+    if (len == 0) break;
+    uint8_t buffer[32];
+    radio.read(buffer, len);
+
+    if (len >= sizeof(BindReply)) {
+      BindReply reply;
+      memcpy(&reply, buffer, sizeof(reply));
+      if (reply.magic == BIND_MAGIC && reply.txId == settings.txId) return true;
+    }
+  }
+  return false;
+}
+
+void finishBind(bool success) {
+  bindState = success ? BIND_SUCCESS : BIND_FAILED;
+
+  if (success) {
+    saveSettings();
+    Serial.println("Bind SUCCESS - settings saved");
+  } else {
+    // Keep the old address - the receiver never confirmed the new one
+    loadSettings();
+    Serial.println("Bind FAILED - no receiver answered");
+  }
+
+  // Back to the normal link on the (new) address and channel
+  radio.flush_rx();
+  configureRadio();
+}
+
+void makeAddressFromTxId(uint32_t txId, char* address) {
+  // 5 characters from the same set the address keyboard uses
+  static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+  for (uint8_t i = 0; i < 5; i++) {
+    address[i] = chars[txId % 36];
+    txId /= 36;
+  }
+  address[5] = '\0';
+}
+
+bool isBindActive() {
+  return currentMenu == MENU_BIND;
+}
+
+bool isBinding() {
+  return bindState == BIND_RUNNING;
+}
+
+void drawBind() {
+  display.setTextSize(1);
+  display.setCursor(0, 0);
+  display.println("Bind Receiver");
+  display.print("ID:");
+  display.print(settings.txId, HEX);
+
+  display.setCursor(0, 20);
+  switch (bindState) {
+    case BIND_RUNNING:
+      display.print("Binding... ");
+      display.print((BIND_TIMEOUT - (millis() - bindStartTime)) / 1000);
+      display.println("s");
+      display.print("Sent:");
+      display.print(bindAttempts);
+      display.print(" Ack:");
+      display.println(bindAcks);
+      break;
+    case BIND_SUCCESS:
+      display.println("BOUND!");
+      display.print("Addr:");
+      display.print(settings.radioAddress);
+      display.print(" Ch:");
+      display.println(settings.radioChannel);
+      break;
+    case BIND_FAILED:
+      display.println("FAILED");
+      display.println("No receiver answered");
+      break;
+    default:
+      break;
+  }
+
+  display.setCursor(0, 52);
+  display.print(bindState == BIND_RUNNING ? "Put RX in bind mode" : "OK:Retry <:Back");
+}
+
+#endif
@@ -15,8 +15,34 @@ struct RCData {
   uint32_t counter;  // Packet counter
 };
 
+// Telemetry returned by the receiver inside the ACK payload (RADIO_ACK_TELEMETRY)
+// Receiver may send a shorter struct - missing trailing fields read as zero
+struct TelemetryData {
+  uint16_t batteryMillivolts;  // Boat battery voltage
+  uint16_t lostFrames;         // Frames the receiver counted as missing (counter gaps)
+  uint16_t loopRate;           // Receiver loop iterations per second
+  uint16_t loopMaxMicros;      // Longest receiver loop in the last second
+  uint32_t echoTimestamp;      // Newest RC_FLAG_TIMESTAMP value received (ping.h)
+  uint16_t outputPeriod;       // Receiver ESC/servo output frame in us, 0 = no phase report (frame_sync.h)
+  uint16_t outputLead;         // From arrival of frame phaseSequence to the next output update (us)
+  uint8_t phaseSequence;       // Low byte of the counter of that frame
+};
+
+// Channel map for the packed packet format (rc_packet.h)
+#define RC_CHANNEL_COUNT 8
+#define CH_STEERING 0       // Right joystick X
+#define CH_THROTTLE 1       // Left joystick Y
+#define CH_RIGHT_JOY_Y 2
+#define CH_LEFT_JOY_X 3
+#define CH_LEFT_POT 4
+#define CH_RIGHT_POT 5
+#define CH_LEFT_TRIGGER 6   // -1000 up, 0 centre, +1000 down
+#define CH_RIGHT_TRIGGER 7  // -1000 up, 0 centre, +1000 down
+
 // External data variable
 extern RCData data;
+extern TelemetryData telemetry;
+extern int16_t channels[RC_CHANNEL_COUNT];
 
 // Pin definitions - Joysticks
 #define RIGHT_JOY_X A1      // Steering control
@@ -51,6 +77,13 @@ extern RCData data;
 // Pin definitions - Radio
 #define RADIO_CE 9
 #define RADIO_CSN 10
+#define RADIO_IRQ 2         // nRF24 IRQ (active LOW) - must be an external interrupt pin
+
+// Pin definitions - PPM output
+#define PPM_PIN 11          // Timer1 OC1A - fixed by the hardware timer (ppm_output.h)
+
+// Pin definitions - Serial protocol output
+// SBUS / CRSF use Serial1: TX1 = pin 18, RX1 = pin 19 (serial_output.h)
 
 // Pin definitions - Display (I2C)
 #define DISPLAY_SDA 20  // I2C SDA
@@ -67,9 +100,44 @@ extern RCData data;
 // Radio constants
 #define RADIO_CHANNEL 76
 #define RADIO_ADDRESS "BOAT1"
+#define RADIO_TX_QUEUED 1       // 1 = load TX FIFO, collect completion via IRQ; 0 = blocking radio.write()
+#define RADIO_ACK_TELEMETRY 0   // 1 = auto-ack with receiver telemetry in the ACK payload
+#define RADIO_FRAME_SYNC 1      // Align frames to the receiver output frame (needs RADIO_ACK_TELEMETRY)
+#define RADIO_RECONFIG_DRAIN 1000 // Max us to wait for the TX FIFO to empty before a reconfiguration
+#define CONTROL_ISR 0           // 1 = Timer3 interrupt samples, calibrates and transmits (control_isr.h)
+#define PROFILER 1              // Per-section timing histograms (profiler.h) - 0 compiles it out
+#define TRACE 1                 // Event trace ring buffer, 640 bytes RAM (trace.h) - 0 compiles it out
+#define SERIAL_TRAINER 1        // Accept channel frames from a PC on the USB port (serial_trainer.h)
+
+// Output modes (SettingsData::outputMode bitmask)
+#define OUTPUT_RADIO 0x01       // nRF24 link
+#define OUTPUT_PPM 0x02         // PPM stream on PPM_PIN for trainer ports / external modules
+#define OUTPUT_SBUS 0x04        // SBUS frames on Serial1 (needs an external inverter)
+#define OUTPUT_CRSF 0x08        // CRSF frames on Serial1 - one serial protocol at a time
+#define OUTPUT_MODE_CHOICES 7   // Combinations offered by Link Settings > Output
+
+// Packet formats - receiver must be built for the same one
+#define PACKET_FORMAT_LEGACY 0  // RCData struct (throttle, steering, counter)
+#define PACKET_FORMAT_PACKED 1  // rc_packet.h - all channels, 11 bits each, sequence + CRC
+#define RADIO_PACKET_FORMAT PACKET_FORMAT_LEGACY
+
+// Redundancy modes (packed format only) - receiver rebuilds single lost frames
+#define REDUNDANCY_OFF 0
+#define REDUNDANCY_DELTA 1      // Each frame also carries the previous frame as deltas
+#define REDUNDANCY_PARITY 2     // XOR parity frame after every RADIO_PARITY_GROUP frames
+#define RADIO_REDUNDANCY REDUNDANCY_OFF
+#define RADIO_PARITY_GROUP 4    // Frames covered by one parity frame (2-16)
+#define RADIO_TEST_DROP_PERCENT 0 // Bench test: withhold this % of frames to simulate raw loss
+#define RADIO_SUBFRAMES 0       // 1 = steering/throttle every frame, aux channels in rotating groups (packed only)
+#define RADIO_SUBFRAME_GROUP 2  // Aux channels per subframe (1-16)
+#define RADIO_SUBFRAME_MIN_RATE 100 // Hz - slower packet rates send every channel in every frame
+#define TELEMETRY_TIMEOUT 1000  // Telemetry older than this (ms) is shown as stale
 
 // Timing constants
-#define TRANSMIT_INTERVAL 20    // 50Hz transmission
+#define TRANSMIT_INTERVAL 20    // 50Hz transmission (start-up rate before the rate scheduler adapts)
+#define RATE_MOTION_THRESHOLD 20 // Stick change (of +-1000) that counts as motion
+#define RATE_HOLD_TIME 500      // Stay at max rate this long (ms) after the last motion
+#define RATE_DECAY_STEP 20      // ms between rate decay steps once idle
 #define DISPLAY_INTERVAL 50     // 20Hz display update
 #define DEADZONE_THRESHOLD 50   // Joystick deadzone
 
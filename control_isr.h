@@ -0,0 +1,212 @@
+/*
+  control_isr.h - Timer-interrupt control path
+  RC Transmitter for Arduino Mega
+
+  With CONTROL_ISR the Timer3 compare interrupt owns the control path end
+  to end: sample and calibrate the sticks (readJoysticks(), or the serial
+  trainer input), pick the packet rate, and transmitData(). Each tick
+  reprograms OCR3A for the next one from getTransmitInterval() plus any
+  frame sync shift, so stick-to-air latency and frame period stay fixed
+  whatever loop() is doing - a display push, an EEPROM save in
+  saveSettings() or the delay() in completeCalibration(). loop() keeps
+  buttons, arming, menus, display, LEDs and the PPM / serial outputs.
+
+  Hand-over to loop(): the ISR writes the back buffer of a double-buffered
+  ControlSnapshot and then flips controlSnapshotIndex. refreshUiSnapshot()
+  copies the front buffer into uiSnapshot with the Timer3 compare
+  interrupt masked for the copy (a few us - a tick due then runs right
+  after), so two flips back to the same buffer cannot tear it. uiSnapshot
+  is what the display and the PPM / serial outputs read in both modes.
+  Without CONTROL_ISR it is a plain copy of data / channels after
+  readJoysticks().
+
+  Sharing rules, as the ISR can run in the middle of any loop() code:
+  - The ISR runs with interrupts enabled (ISR_NOBLOCK), so UART, millis()
+    and fast disarm keep running. A tick that finds the previous one still
+    running is dropped and counted.
+  - Radio: the ISR only transmits outside radio sections (beginRadioUse /
+    endRadioUse) and while no menu tool owns the chip. A busy tick is
+    skipped and counted. A fast disarm that lands during the transmit is
+    sent right after it.
+  - ADC: loop() still calls analogRead() (calibration, info pages). The
+    ISR waits for a conversion in flight, and on the way out converts the
+    channel loop() had selected again, so both sides read their own pin.
+  - Serial: HardwareSerial::write() is not reentrant, and the ISR can land
+    in the middle of a Serial.print() in loop(). The transmit path prints
+    nothing in this mode - the debug output (radio.h) and the link adapt
+    messages (link_adapt.h) are off, and their counters are in the status
+    dump. applyRadioConfig() skips the tick instead of waiting for the TX
+    FIFO to drain.
+
+  Cost: six analogRead() calls (about 0.7 ms) plus the SPI transfer per
+  tick - about half the CPU at 500 Hz.
+*/
+
+#ifndef CONTROL_ISR_H
+#define CONTROL_ISR_H
+
+#include "config.h"
+#include "controls.h"
+#include "radio.h"
+#include "fast_disarm.h"
+#include "serial_trainer.h"
+#include "profiler.h"
+
+// Control ISR constants
+#define CONTROL_ISR_TICK 4            // us per Timer3 tick (16 MHz / 64)
+#define CONTROL_ISR_MARGIN 8          // Ticks OCR3A must stay ahead of TCNT3 when reprogrammed
+
+// Control values handed from the control path to the UI
+struct ControlSnapshot {
+  RCData data;
+  int16_t channels[RC_CHANNEL_COUNT];
+  uint32_t tick;
+};
+
+ControlSnapshot controlSnapshots[2];
+volatile uint8_t controlSnapshotIndex = 0;   // Front buffer, written last by the ISR
+ControlSnapshot uiSnapshot;                  // loop()'s copy for the display and outputs
+
+// Control ISR state
+volatile bool controlLinkEnabled = false;    // Set by loop() - output mode and menu tools
+volatile bool controlIsrRunning = false;
+uint32_t controlIsrTicks = 0;
+uint32_t controlIsrBusySkips = 0;            // Radio held by loop()
+uint32_t controlIsrOverlaps = 0;             // Tick dropped, previous still running
+unsigned long controlIsrPeriod = 0;          // us programmed for the current tick
+unsigned long lastControlIsrStart = 0;
+unsigned long lastControlIsrMicros = 0;
+unsigned long worstControlIsrMicros = 0;
+unsigned long worstControlJitter = 0;        // us between the programmed and the actual period
+
+// Forward declare link checks (menu.h, menu_data.h)
+extern bool isLinkPaused();
+extern bool isRadioOutputEnabled();
+
+// Function declarations
+void initControlIsr();
+void runControlTick();
+void publishControlSnapshot();
+void refreshUiSnapshot();
+void setControlLinkEnabled(bool enabled);
+
+void initControlIsr() {
+#if CONTROL_ISR
+  controlIsrPeriod = getTransmitInterval();
+  noInterrupts();
+  TCCR3A = 0;
+  TCCR3B = 0;
+  TCNT3 = 0;
+  OCR3A = min(controlIsrPeriod / CONTROL_ISR_TICK, 65535UL) - 1;
+  TCCR3B = _BV(WGM32) | _BV(CS31) | _BV(CS30); // CTC, TOP = OCR3A, clk/64
+  TIMSK3 = _BV(OCIE3A);
+  interrupts();
+  lastControlIsrStart = micros();
+  Serial.println("Control path on Timer3 interrupt");
+#endif
+}
+
+#if CONTROL_ISR
+ISR(TIMER3_COMPA_vect, ISR_NOBLOCK) {
+  if (controlIsrRunning) {
+    controlIsrOverlaps++;
+    return;
+  }
+  controlIsrRunning = true;
+  runControlTick();
+  controlIsrRunning = false;
+}
+#endif
+
+void runControlTick() {
+  unsigned long start = micros();
+  unsigned long actual = start - lastControlIsrStart;
+  unsigned long jitter = actual > controlIsrPeriod ? actual - controlIsrPeriod : controlIsrPeriod - actual;
+  if (controlIsrTicks > 0 && jitter > worstControlJitter) worstControlJitter = jitter;
+  lastControlIsrStart = start;
+  controlIsrTicks++;
+
+  // Let a conversion started by loop() finish, and remember its channel
+  uint8_t savedMux = ADMUX;
+  uint8_t savedMuxB = ADCSRB;
+  while (bit_is_set(ADCSRA, ADSC));
+
+  PROF_BEGIN(PROF_JOYSTICKS);
+  if (isTrainerActive()) {
+    applyTrainerInput();
+  } else {
+    readJoysticks();
+  }
+  PROF_END(PROF_JOYSTICKS);
+  updatePacketRate();
+
+  // Convert loop()'s channel again so an interrupted analogRead() gets its own pin
+  ADCSRB = savedMuxB;
+  ADMUX = savedMux;
+  ADCSRA |= _BV(ADSC);
+  while (bit_is_set(ADCSRA, ADSC));
+
+  long shift = 0;
+  if (controlLinkEnabled && !isLinkPaused()) {
+    if (radioBusy) {
+      controlIsrBusySkips++;
+    } else {
+      radioBusy = true;
+      PROF_BEGIN(PROF_TRANSMIT);
+      transmitData();
+      PROF_END(PROF_TRANSMIT);
+      shift = takeFrameSyncShift(data.counter + 1);
+      // A fast disarm that came in during the transmit goes out now
+      if (disarmBurstPending && radioBurstAllowed) {
+        disarmBurstPending = false;
+        deferredDisarmCount++;
+        runDisarmBurst();
+      }
+      radioBusy = false;
+    }
+  }
+  publishControlSnapshot();
+
+  // Next tick - the counter restarted at this compare match
+  long period = (long)getTransmitInterval() + shift;
+  long earliest = (long)TCNT3 + CONTROL_ISR_MARGIN;
+  long ticks = constrain(period / CONTROL_ISR_TICK, earliest, 65535L);
+  OCR3A = ticks - 1;
+  controlIsrPeriod = ticks * CONTROL_ISR_TICK;
+
+  lastControlIsrMicros = micros() - start;
+  if (lastControlIsrMicros > worstControlIsrMicros) worstControlIsrMicros = lastControlIsrMicros;
+}
+
+void publishControlSnapshot() {
+  // Fill the back buffer, then make it the front one in a single byte write
+  uint8_t back = controlSnapshotIndex ^ 1;
+  controlSnapshots[back].data = data;
+  memcpy(controlSnapshots[back].channels, channels, sizeof(channels));
+  controlSnapshots[back].tick = controlIsrTicks;
+  controlSnapshotIndex = back;
+}
+
+void refreshUiSnapshot() {
+#if CONTROL_ISR
+  // Hold the tick off for the copy - retrying on the index alone misses two
+  // flips that land back on the same buffer while it is being rewritten.
+  // TIMSK3 is otherwise only written by initControlIsr() in setup().
+  uint8_t timsk = TIMSK3;
+  TIMSK3 = timsk & ~_BV(OCIE3A);
+  __asm__ __volatile__("" ::: "memory");
+  memcpy(&uiSnapshot, &controlSnapshots[controlSnapshotIndex], sizeof(uiSnapshot));
+  __asm__ __volatile__("" ::: "memory");
+  TIMSK3 = timsk;
+#else
+  uiSnapshot.data = data;
+  memcpy(uiSnapshot.channels, channels, sizeof(channels));
+  uiSnapshot.tick = data.counter;
+#endif
+}
+
+void setControlLinkEnabled(bool enabled) {
+  controlLinkEnabled = enabled;
+}
+
+#endif
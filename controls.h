@@ -11,6 +11,10 @@
 // Forward declare calibration functions
 extern int getCalibratedSteering();
 extern int getCalibratedThrottle();
+extern int getCalibratedRightJoyY();
+extern int getCalibratedLeftJoyX();
+extern int getCalibratedLeftPot();
+extern int getCalibratedRightPot();
 
 // Function declarations
 void initControls();
@@ -18,6 +22,7 @@ void readJoysticks();
 void checkButtons();
 void setLED(bool red, bool green, bool blue);
 bool getArmedStatus();
+int getTriggerChannel(bool up, bool down);
 
 // Button state variables
 struct ButtonStates {
@@ -36,8 +41,8 @@ struct ButtonStates {
 
 ButtonStates buttons;
 
-// Arming system
-bool isArmed = false;
+// Arming system - also cleared by the fast disarm ISR (fast_disarm.h)
+volatile bool isArmed = false;
 bool lastLeftTriggerDown = false;
 
 // Potentiometer values
@@ -72,24 +77,52 @@ void initControls() {
 }
 
 void readJoysticks() {
-  // Only process joystick inputs if ARMED
-  if (isArmed) {
-    // Use calibrated values if available, otherwise use default mapping
-    data.steering = getCalibratedSteering();
-    data.throttle = getCalibratedThrottle();
-    
-    // Apply deadzone to prevent drift
-    if (abs(data.steering) < DEADZONE_THRESHOLD) data.steering = 0;
-    if (abs(data.throttle) < DEADZONE_THRESHOLD) data.throttle = 0;
-  } else {
+  // Read every stick first - the fast disarm ISR may clear isArmed meanwhile
+  int steering = getCalibratedSteering();
+  int throttle = getCalibratedThrottle();
+  int rightJoyY = getCalibratedRightJoyY();
+  int leftJoyX = getCalibratedLeftJoyX();
+  
+  // Apply deadzone to prevent drift
+  if (abs(steering) < DEADZONE_THRESHOLD) steering = 0;
+  if (abs(throttle) < DEADZONE_THRESHOLD) throttle = 0;
+  if (abs(rightJoyY) < DEADZONE_THRESHOLD) rightJoyY = 0;
+  if (abs(leftJoyX) < DEADZONE_THRESHOLD) leftJoyX = 0;
+  
+  // Only pass joystick inputs if ARMED, decided and stored atomically so a
+  // disarm can never be overwritten by values read before it
+  noInterrupts();
+  if (!isArmed) {
     // DISARMED - force neutral values
-    data.steering = 0;
-    data.throttle = 0;
+    steering = 0;
+    throttle = 0;
+    rightJoyY = 0;
+    leftJoyX = 0;
   }
+  data.steering = steering;
+  data.throttle = throttle;
+  channels[CH_STEERING] = steering;
+  channels[CH_THROTTLE] = throttle;
+  channels[CH_RIGHT_JOY_Y] = rightJoyY;
+  channels[CH_LEFT_JOY_X] = leftJoyX;
+  interrupts();
   
   // Read potentiometers (always active)
   leftPotValue = analogRead(LEFT_POT);
   rightPotValue = analogRead(RIGHT_POT);
+  
+  // Fill the rest of the channel set for the packed packet format
+  channels[CH_LEFT_POT] = getCalibratedLeftPot();
+  channels[CH_RIGHT_POT] = getCalibratedRightPot();
+  channels[CH_LEFT_TRIGGER] = getTriggerChannel(buttons.leftTriggerUp, buttons.leftTriggerDown);
+  channels[CH_RIGHT_TRIGGER] = getTriggerChannel(buttons.rightTriggerUp, buttons.rightTriggerDown);
+}
+
+int getTriggerChannel(bool up, bool down) {
+  // 3-position switch: up / centre / down
+  if (down) return 1000;
+  if (up) return -1000;
+  return 0;
 }
 
 void checkButtons() {
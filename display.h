@@ -1,6 +1,12 @@
 /*
   display.h - OLED display functions with Menu Integration
   RC Transmitter for Arduino Mega
+
+  updateDisplay() only draws into the RAM frame buffer. The buffer goes to
+  the panel in DISPLAY_CHUNK_BYTES pieces through pushDisplayChunk(), one
+  scheduler slot each (scheduler.h), so a full 1 KB push (about 25 ms at
+  400 kHz) never sits in front of a radio frame. A new frame is only drawn
+  once the previous push has finished, so the panel never shows a mix.
 */
 
 #ifndef DISPLAY_H
@@ -12,6 +18,8 @@
 #include "config.h"
 #include "radio.h"
 #include "controls.h"
+#include "control_isr.h"
+#include "trace.h"
 
 // Forward declare menu functions
 extern bool isMenuActive();
@@ -20,6 +28,14 @@ extern void drawMenu();
 // Display object
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
 
+// Chunked push
+#define DISPLAY_BUFFER_BYTES (SCREEN_WIDTH * SCREEN_HEIGHT / 8)
+#define DISPLAY_CHUNK_BYTES 64        // Bytes per pushDisplayChunk() call (about 1.8 ms at 400 kHz)
+#define DISPLAY_I2C_CLOCK 400000      // Same clocks Adafruit_SSD1306::display() uses
+#define DISPLAY_I2C_IDLE_CLOCK 100000
+#define DISPLAY_I2C_BUFFER 32         // AVR Wire buffer (BUFFER_LENGTH), data prefix included
+uint16_t displayPushOffset = DISPLAY_BUFFER_BYTES; // Next byte to send, DISPLAY_BUFFER_BYTES when idle
+
 // Table position and size variables - adjust these to move/resize the table
 int table_start_x = 10;
 int table_start_y = 16;
@@ -52,6 +68,9 @@ void drawValuesTable();
 void displayError(const char* message);
 void drawMainDisplay();
 void drawMenuHint();
+void startDisplayPush();
+bool pushDisplayChunk();
+bool isDisplayPushPending();
 
 void initDisplay() {
   Serial.print("Initializing display... ");
@@ -75,14 +94,15 @@ void initDisplay() {
 }
 
 void updateDisplay() {
+  TRACE_BEGIN(TRACE_DISPLAY_DRAW);
   // Check if menu is active
   if (isMenuActive()) {
     drawMenu();
-    return;
+  } else {
+    // Draw normal operating display
+    drawMainDisplay();
   }
-  
-  // Draw normal operating display
-  drawMainDisplay();
+  TRACE_END(TRACE_DISPLAY_DRAW);
 }
 
 void drawMainDisplay() {
@@ -91,14 +111,32 @@ void drawMainDisplay() {
   // === YELLOW AREA (0-15 pixels) ===
   display.setTextSize(1);
   display.setCursor(0, 0);
-  display.print("RC TX - ");
-  display.print(isRadioOK() ? "ONLINE" : "OFFLINE");
+  if (isTelemetryFresh()) {
+    // Receiver is answering - show the boat's side of the link instead
+    display.print("RX ");
+    display.print(telemetry.batteryMillivolts / 1000.0, 2);
+    display.print("V LOST:");
+    display.print(telemetry.lostFrames);
+  } else {
+    display.print("RC TX - ");
+    display.print(isRadioOK() ? "ONLINE" : "OFFLINE");
+  }
   
-  // Armed status and packet counter
+  // Armed status and link quality (packet count is in System Info)
   display.setCursor(0, 8);
-  display.print(getArmedStatus() ? "ARMED" : "DISARMED");
-  display.print(" PKT:");
-  display.print(data.counter);
+  display.print(getArmedStatus() ? "ARMED " : "DISARMED ");
+  display.print(linkStats.effectiveRate);
+  display.print("Hz");
+#if RADIO_ACK_TELEMETRY
+  display.print(" L:");
+  display.print(getLinkLossPercent());
+  display.print("%");
+#else
+  // No ACKs - loss is not visible here, show the worst frame gap instead
+  display.print(" G:");
+  display.print(linkStats.worstGap / 1000);
+  display.print("ms");
+#endif
   
   // === BLUE AREA (16-63 pixels) ===
   
@@ -112,7 +150,7 @@ void drawMainDisplay() {
   // Draw menu hint at bottom
   drawMenuHint();
   
-  display.display();
+  startDisplayPush();
 }
 
 void drawMenuHint() {
@@ -133,13 +171,13 @@ void drawThrottleBar() {
   display.drawRect(barX, barY, barWidth, barHeight, SSD1306_WHITE);
   
   // Calculate fill height based on throttle value
-  int fillHeight = map(abs(data.throttle), 0, 1000, 0, barHeight / 2 - 1);
+  int fillHeight = map(abs(uiSnapshot.data.throttle), 0, 1000, 0, barHeight / 2 - 1);
   
-  if (data.throttle > 0) {
+  if (uiSnapshot.data.throttle > 0) {
     // Forward - fill from center up
     int fillY = barY + (barHeight / 2) - fillHeight;
     display.fillRect(barX + 1, fillY, barWidth - 2, fillHeight, SSD1306_WHITE);
-  } else if (data.throttle < 0) {
+  } else if (uiSnapshot.data.throttle < 0) {
     // Reverse - fill from center down
     int fillY = barY + (barHeight / 2);
     display.fillRect(barX + 1, fillY, barWidth - 2, fillHeight, SSD1306_WHITE);
@@ -161,13 +199,13 @@ void drawSteeringBar() {
   display.drawRect(barX, barY, barWidth, barHeight, SSD1306_WHITE);
   
   // Calculate fill width based on steering value
-  int fillWidth = map(abs(data.steering), 0, 1000, 0, barWidth / 2 - 1);
+  int fillWidth = map(abs(uiSnapshot.data.steering), 0, 1000, 0, barWidth / 2 - 1);
   
-  if (data.steering > 0) {
+  if (uiSnapshot.data.steering > 0) {
     // Right - fill from center right
     int fillX = barX + (barWidth / 2);
     display.fillRect(fillX, barY + 1, fillWidth, barHeight - 2, SSD1306_WHITE);
-  } else if (data.steering < 0) {
+  } else if (uiSnapshot.data.steering < 0) {
     // Left - fill from center left
     int fillX = barX + (barWidth / 2) - fillWidth;
     display.fillRect(fillX, barY + 1, fillWidth, barHeight - 2, SSD1306_WHITE);
@@ -232,7 +270,7 @@ void drawValuesTable() {
   display.setCursor(tableX + table_text_offset_x, tableY + headerHeight + table_text_offset_y);
   display.print("THR");
   display.setCursor(tableX + col1Width + table_text_offset_x, tableY + headerHeight + table_text_offset_y);
-  display.print(data.throttle);
+  display.print(uiSnapshot.data.throttle);
   display.setCursor(tableX + col1Width + col2Width + table_text_offset_x, tableY + headerHeight + table_text_offset_y);
   display.print(analogRead(LEFT_JOY_Y));
   
@@ -240,7 +278,7 @@ void drawValuesTable() {
   display.setCursor(tableX + table_text_offset_x, tableY + headerHeight + rowHeight + table_text_offset_y);
   display.print("STR");
   display.setCursor(tableX + col1Width + table_text_offset_x, tableY + headerHeight + rowHeight + table_text_offset_y);
-  display.print(data.steering);
+  display.print(uiSnapshot.data.steering);
   display.setCursor(tableX + col1Width + col2Width + table_text_offset_x, tableY + headerHeight + rowHeight + table_text_offset_y);
   display.print(analogRead(RIGHT_JOY_X));
 }
@@ -254,4 +292,42 @@ void displayError(const char* message) {
   display.display();
 }
 
+void startDisplayPush() {
+  // Horizontal addressing (set by display.begin()) - the panel advances its
+  // own pointer, so later chunks are plain data
+  display.ssd1306_command(SSD1306_PAGEADDR);
+  display.ssd1306_command(0);
+  display.ssd1306_command(0xFF);
+  display.ssd1306_command(SSD1306_COLUMNADDR);
+  display.ssd1306_command(0);
+  display.ssd1306_command(SCREEN_WIDTH - 1);
+  displayPushOffset = 0;
+}
+
+bool pushDisplayChunk() {
+  // Returns true while more of the frame is left to send
+  if (displayPushOffset >= DISPLAY_BUFFER_BYTES) return false;
+  uint8_t* buffer = display.getBuffer();
+  uint16_t end = min(displayPushOffset + DISPLAY_CHUNK_BYTES, DISPLAY_BUFFER_BYTES);
+
+  TRACE_BEGIN(TRACE_DISPLAY_PUSH);
+  Wire.setClock(DISPLAY_I2C_CLOCK);
+  while (displayPushOffset < end) {
+    // One I2C transaction per Wire buffer
+    Wire.beginTransmission(SCREEN_ADDRESS);
+    Wire.write((uint8_t)0x40);
+    for (uint8_t n = 1; n < DISPLAY_I2C_BUFFER && displayPushOffset < end; n++) {
+      Wire.write(buffer[displayPushOffset++]);
+    }
+    Wire.endTransmission();
+  }
+  Wire.setClock(DISPLAY_I2C_IDLE_CLOCK);
+  TRACE_END(TRACE_DISPLAY_PUSH);
+  return displayPushOffset < DISPLAY_BUFFER_BYTES;
+}
+
+bool isDisplayPushPending() {
+  return displayPushOffset < DISPLAY_BUFFER_BYTES;
+}
+
 #endif
\ No newline at end of file
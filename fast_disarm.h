@@ -0,0 +1,138 @@
+/*
+  fast_disarm.h - Instant disarm on left trigger release
+  RC Transmitter for Arduino Mega
+
+  checkButtons() only sees the trigger once per loop() pass, and the next
+  transmitData() tick can be a blocking display push away. The left
+  trigger pin has no external or pin-change interrupt on the Mega, so it
+  is polled from the Timer0 compare B interrupt (every 1.024 ms, next to
+  the millis() overflow interrupt - OCR0B only drives PWM on pin 4, which
+  is a button input here). On a release while armed the ISR:
+  - disarms and zeroes data.throttle / data.steering and the joystick
+    channels at once,
+  - sends DISARM_BURST_FRAMES neutral frames straight away through
+    sendNeutralBurst() (radio.h), flushing any armed frames still queued,
+  - records the trigger-to-air latency.
+
+  The radio is shared with loop(), so the ISR only touches it while
+  loop() is outside a radio section (beginRadioUse / endRadioUse). With
+  the blocking TX path, or when the release lands inside a radio section,
+  the burst goes out from endRadioUse() instead - still before any
+  display push. Frames for other TDMA slots go out on their next tick.
+
+  Latency is measured from the poll that saw the release (up to 1.024 ms
+  after the edge) to the end of the first burst frame on air, estimated
+  from the queue time plus PLL settling and frame airtime.
+*/
+
+#ifndef FAST_DISARM_H
+#define FAST_DISARM_H
+
+#include "config.h"
+#include "controls.h"
+#include "radio.h"
+
+// Fast disarm constants
+#define DISARM_BURST_FRAMES 3         // Neutral frames per burst (TX FIFO depth)
+#define DISARM_POLL_COMPARE 0x80      // OCR0B value - half way between millis() ticks
+#define RADIO_SETTLE_MICROS 130       // nRF24 PLL settling before the first bit
+
+// Fast disarm state
+volatile bool radioBusy = false;          // loop() is inside a radio section
+uint8_t radioUseDepth = 0;                // Radio sections nest (menu tools inside exitMenu())
+volatile bool radioBurstAllowed = false;  // Link running and radio healthy
+volatile bool disarmBurstPending = false;
+volatile bool disarmReportPending = false;
+volatile bool fastDisarmLastDown = false;
+volatile unsigned long disarmDetectedAt = 0;
+unsigned long lastDisarmLatency = 0;      // us, trigger poll to first frame on air
+unsigned long worstDisarmLatency = 0;
+uint16_t fastDisarmCount = 0;
+uint16_t deferredDisarmCount = 0;         // Bursts sent from loop() instead of the ISR
+
+// Forward declare link checks (menu.h, menu_data.h)
+extern bool isLinkPaused();
+extern bool isRadioOutputEnabled();
+
+// Function declarations
+void initFastDisarm();
+void handleFastDisarm();
+void runDisarmBurst();
+void beginRadioUse();
+void endRadioUse();
+
+void initFastDisarm() {
+  fastDisarmLastDown = !digitalRead(LEFT_TRIGGER_DOWN);
+  OCR0B = DISARM_POLL_COMPARE;
+  TIMSK0 |= _BV(OCIE0B);
+  Serial.println("Fast disarm poll on Timer0 COMPB");
+}
+
+ISR(TIMER0_COMPB_vect) {
+  bool down = !digitalRead(LEFT_TRIGGER_DOWN);
+  if (fastDisarmLastDown && !down && isArmed) handleFastDisarm();
+  fastDisarmLastDown = down;
+}
+
+void handleFastDisarm() {
+  // Interrupt context - no Serial here
+  isArmed = false;
+  data.throttle = 0;
+  data.steering = 0;
+  channels[CH_STEERING] = 0;
+  channels[CH_THROTTLE] = 0;
+  channels[CH_RIGHT_JOY_Y] = 0;
+  channels[CH_LEFT_JOY_X] = 0;
+  // checkButtons() sees the trigger as released, so holding it again re-arms
+  buttons.leftTriggerDown = false;
+  disarmDetectedAt = micros();
+  disarmReportPending = true;
+  fastDisarmCount++;
+
+#if RADIO_TX_QUEUED
+  if (!radioBusy && radioBurstAllowed) {
+    runDisarmBurst();
+    return;
+  }
+#endif
+  disarmBurstPending = true;
+}
+
+void runDisarmBurst() {
+  uint8_t length = sendNeutralBurst(DISARM_BURST_FRAMES);
+  if (length == 0) return;
+  lastDisarmLatency = lastFrameQueuedAt - disarmDetectedAt + RADIO_SETTLE_MICROS + getFrameAirtime(length);
+  if (lastDisarmLatency > worstDisarmLatency) worstDisarmLatency = lastDisarmLatency;
+}
+
+void beginRadioUse() {
+  radioUseDepth++;
+  radioBusy = true;
+}
+
+void endRadioUse() {
+  if (radioUseDepth > 0 && --radioUseDepth > 0) return;
+  radioBurstAllowed = radioOK && isRadioOutputEnabled() && !isLinkPaused();
+
+  noInterrupts();
+  bool pending = disarmBurstPending;
+  bool report = disarmReportPending;
+  disarmBurstPending = false;
+  disarmReportPending = false;
+  radioBusy = false;
+  interrupts();
+
+  if (pending && radioBurstAllowed) {
+    deferredDisarmCount++;
+    radioBusy = true;
+    runDisarmBurst();
+    radioBusy = false;
+  }
+  if (report) {
+    Serial.print("SYSTEM DISARMED (fast) - ");
+    Serial.print(lastDisarmLatency);
+    Serial.println(" us to air");
+  }
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*
+  frame_sync.h - Receiver frame-phase alignment
+  RC Transmitter for Arduino Mega
+
+  The receiver updates its ESC / servo outputs on its own frame (about
+  20 ms). A free-running transmit schedule lands each command at a random
+  point of that frame, so it waits 0-20 ms before it takes effect. With
+  RADIO_FRAME_SYNC the transmit schedule is shifted so frames arrive
+  SYNC_TARGET_LEAD before the receiver's output update, which cuts the
+  average latency by about half a receiver frame at the same packet rate.
+
+  Phase contract (receiver side, in TelemetryData):
+  - outputPeriod: the receiver output frame in us, 0 if it does not report.
+  - outputLead: time from the arrival of frame phaseSequence to the next
+    output update, in us.
+  - phaseSequence: low byte of that frame's counter.
+
+  The report arrives one frame late (ACK payloads are preloaded), so each
+  report moves the schedule by only 1/SYNC_GAIN of the error, and reports
+  about frames sent before the last shift are ignored. The error is taken
+  modulo the shorter of the transmit interval and the receiver frame, so
+  any rate whose interval divides (or is a multiple of) the receiver frame
+  locks. Other rates, and TDMA (one schedule for several receivers), run
+  unsynchronised. Needs RADIO_ACK_TELEMETRY.
+*/
+
+#ifndef FRAME_SYNC_H
+#define FRAME_SYNC_H
+
+#include "config.h"
+
+// Frame sync constants
+#define SYNC_TARGET_LEAD 1500         // us between frame arrival and output update (decode + margin)
+#define SYNC_GAIN 4                   // Fraction of the phase error corrected per report
+#define SYNC_MAX_SHIFT 2000           // us, largest single schedule shift
+#define SYNC_LOCK_WINDOW 500          // us of error that still counts as locked
+#define SYNC_PERIOD_TOLERANCE 200     // us mismatch allowed when matching the receiver frame
+
+// Frame sync state
+long frameSyncShift = 0;              // Pending shift for the transmit schedule (us)
+uint32_t frameSyncCounter = 0;        // First frame sent after the last shift
+long frameSyncError = 0;              // Last phase error (us)
+unsigned long frameSyncLead = 0;      // Last reported lead (us)
+bool frameSyncLocked = false;
+uint32_t frameSyncReports = 0;
+uint8_t frameSyncLastSequence = 0;
+
+// Forward declare radio getters
+extern unsigned long getTransmitInterval();
+extern bool isTdmaEnabled();
+
+// Function declarations
+void recordFramePhase(uint16_t outputPeriod, uint16_t outputLead, uint8_t phaseSequence);
+long takeFrameSyncShift(uint32_t nextCounter);
+bool isFrameSyncActive();
+bool isFrameSyncLocked();
+
+void recordFramePhase(uint16_t outputPeriod, uint16_t outputLead, uint8_t phaseSequence) {
+#if RADIO_FRAME_SYNC && RADIO_ACK_TELEMETRY
+  if (outputPeriod == 0 || isTdmaEnabled()) {
+    frameSyncLocked = false;
+    return;
+  }
+  // Every ACK repeats the last report until a newer frame arrives
+  if (frameSyncReports > 0 && phaseSequence == frameSyncLastSequence) return;
+  frameSyncLastSequence = phaseSequence;
+  // Reports about frames sent before the last shift describe the old phase
+  if (frameSyncCounter != 0 && (int8_t)(phaseSequence - (uint8_t)frameSyncCounter) < 0) return;
+  frameSyncReports++;
+  frameSyncLead = outputLead;
+
+  // Only a transmit interval that divides the receiver frame (or is a
+  // multiple of it) keeps a fixed phase - the shorter one is the cycle
+  unsigned long interval = getTransmitInterval();
+  unsigned long cycle = min(interval, (unsigned long)outputPeriod);
+  unsigned long remainder = max(interval, (unsigned long)outputPeriod) % cycle;
+  if (remainder > SYNC_PERIOD_TOLERANCE && cycle - remainder > SYNC_PERIOD_TOLERANCE) {
+    frameSyncLocked = false;
+    return;
+  }
+
+  // Positive error - the frame arrived too early, so send later
+  long error = ((long)outputLead - SYNC_TARGET_LEAD) % (long)cycle;
+  if (error > (long)cycle / 2) error -= cycle;
+  if (error < -(long)cycle / 2) error += cycle;
+  frameSyncError = error;
+  frameSyncLocked = abs(error) <= SYNC_LOCK_WINDOW;
+
+  frameSyncShift = constrain(error / SYNC_GAIN, -SYNC_MAX_SHIFT, SYNC_MAX_SHIFT);
+#endif
+}
+
+long takeFrameSyncShift(uint32_t nextCounter) {
+  // Called once per transmit - the shift applies to the schedule from here
+  long shift = frameSyncShift;
+  if (shift != 0) {
+    frameSyncShift = 0;
+    frameSyncCounter = nextCounter;
+  }
+  return shift;
+}
+
+bool isFrameSyncActive() {
+  return RADIO_FRAME_SYNC && RADIO_ACK_TELEMETRY && frameSyncReports > 0 && !isTdmaEnabled();
+}
+
+bool isFrameSyncLocked() {
+  return isFrameSyncActive() && frameSyncLocked;
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*
+  hopping.h - Frequency hopping sequence and timing contract
+  RC Transmitter for Arduino Mega
+
+  The hop table is a pseudo-random list of HOP_TABLE_SIZE channels generated
+  from a 16-bit seed (SettingsData::hopSeed). The generator only uses integer
+  math so the receiver can build the identical table from the same seed,
+  and only depends on <stdint.h>/<stdlib.h> so it builds on a PC as well
+  (tests/rc_packet_test.cpp). Every pair of consecutive hops is at least
+  HOP_MIN_SPACING apart, including the wrap from the last entry back to
+  the first.
+
+  Timing contract (receiver side):
+  - The packet with counter C is always sent on
+      hopTable[(C / hopInterval) % HOP_TABLE_SIZE]
+    so the channel follows from data.counter alone, never from wall time.
+    This keeps the contract valid while the packet rate adapts.
+  - hopInterval is a power of two (1, 2, 4 or 8) and HOP_TABLE_SIZE is 16,
+    so the sequence stays continuous when the 32-bit counter wraps.
+  - The transmitter only changes channel between packets with an empty TX
+    FIFO, so no packet is ever split across two channels.
+  - After receiving packet C the receiver tunes to the channel of C + 1.
+    If nothing arrives within 1.5x the last measured packet gap it assumes
+    one packet was lost, advances its expected counter by one and retunes.
+  - After HOP_TABLE_SIZE consecutive misses the receiver parks on its
+    current table channel. The transmitter returns to every table channel
+    once per HOP_TABLE_SIZE * hopInterval packets, which bounds the resync
+    time to HOP_TABLE_SIZE * hopInterval / minPacketRate seconds.
+  - Loss is measured on the receiver from gaps in data.counter, exactly as
+    without hopping.
+  - With the packed packet format only the low 8 bits of the counter are
+    sent. 256 is a multiple of HOP_TABLE_SIZE * hopInterval, so the
+    receiver can use the sequence byte in place of the counter.
+*/
+
+#ifndef HOPPING_H
+#define HOPPING_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Hop table constants
+#define HOP_TABLE_SIZE 16     // Channels per hop sequence (power of two)
+#define HOP_CHANNEL_MIN 2     // Lowest channel used (2402 MHz)
+#define HOP_CHANNEL_SPAN 80   // Channels 2-81 (2402-2481 MHz)
+#define HOP_MIN_SPACING 5     // Consecutive hops at least 5 MHz apart
+
+// Function declarations
+uint16_t hopRandom(uint16_t &state);
+void generateHopTable(uint16_t seed, uint8_t* table);
+uint8_t getHopChannel(const uint8_t* table, uint32_t counter, uint8_t hopInterval);
+
+uint16_t hopRandom(uint16_t &state) {
+  // xorshift16 (7, 9, 8) - full period over all non-zero states
+  state ^= state << 7;
+  state ^= state >> 9;
+  state ^= state << 8;
+  return state;
+}
+
+void generateHopTable(uint16_t seed, uint8_t* table) {
+  uint16_t state = seed ? seed : 0xACE1; // xorshift must not start at zero
+  uint8_t count = 0;
+
+  while (count < HOP_TABLE_SIZE) {
+    uint8_t channel = HOP_CHANNEL_MIN + hopRandom(state) % HOP_CHANNEL_SPAN;
+    bool valid = true;
+
+    // No repeats, and keep consecutive hops out of the same Wi-Fi channel
+    for (uint8_t i = 0; i < count; i++) {
+      if (table[i] == channel) valid = false;
+    }
+    if (count > 0 && abs((int)channel - (int)table[count - 1]) < HOP_MIN_SPACING) valid = false;
+    // The last entry is followed by the first when the sequence wraps
+    if (count == HOP_TABLE_SIZE - 1 && abs((int)channel - (int)table[0]) < HOP_MIN_SPACING) valid = false;
+
+    if (valid) table[count++] = channel;
+  }
+}
+
+uint8_t getHopChannel(const uint8_t* table, uint32_t counter, uint8_t hopInterval) {
+  return table[(counter / hopInterval) % HOP_TABLE_SIZE];
+}
+
+#endif
@@ -0,0 +1,239 @@
+/*
+  link_adapt.h - Closed-loop PA level, data rate and retry adaptation
+  RC Transmitter for Arduino Mega
+
+  Walks a ladder of radio settings ordered from cheapest (2 Mbps, minimum
+  power) to most robust (250 kbps, maximum power) using the loss measured
+  from auto-ack results in link_stats.h, so it needs RADIO_ACK_TELEMETRY.
+  - Loss above ADAPT_LOSS_HIGH in a decision period: one step up (two if
+    the loss is very high), and the good time needed before the next step
+    down doubles, so a marginal step is not retried every few seconds.
+  - Loss at or below ADAPT_LOSS_TARGET for that many periods: one step down.
+  - No ACK at all for ADAPT_FALLBACK_TIME: straight to the top step.
+  Changes are applied between frames through the hot reconfiguration in
+  radio.h.
+  When the link was paused (bind, spectrum scan, radio test, radio
+  recovery) no ACKs came back by design. restartLinkAdapt() forgets the
+  last delivered frame and starts again from the robust step at the bound
+  rate, where the receiver looks for the transmitter after a gap, so the
+  pause is not taken for a dead link.
+
+  Data rate contract (receiver side):
+  - The receiver boots at the bound data rate (SettingsData::dataRate).
+  - A data rate change is announced for ADAPT_ANNOUNCE_FRAMES frames with
+    the RC_FLAG_LINK_CONFIG trailer (rc_packet.h), which holds the new rate
+    and the sequence of the first frame sent at it. The receiver switches
+    once it receives or times out on the frame before that sequence.
+  - After 2 * ADAPT_FALLBACK_TIME without a valid frame the receiver
+    switches to ADAPT_FALLBACK_RATE, where the transmitter already is
+    because it saw no ACKs for ADAPT_FALLBACK_TIME. While frames still do
+    not arrive it alternates between that and the bound rate with the
+    same period, which also finds a transmitter that had adaptation
+    switched off.
+  Announcements need the packed format and a single receiver, so with
+  the legacy format or TDMA the data rate stays at the bound rate and only
+  PA level and retries adapt.
+*/
+
+#ifndef LINK_ADAPT_H
+#define LINK_ADAPT_H
+
+#include "config.h"
+#include "link_stats.h"
+
+// Adaptation constants
+#define ADAPT_PERIOD 1000             // ms between decisions
+#define ADAPT_MIN_FRAMES 20           // Frames needed in a period to decide
+#define ADAPT_LOSS_TARGET 2           // % loss at or below which a cheaper step is tried
+#define ADAPT_LOSS_HIGH 10            // % loss above which a more robust step is taken
+#define ADAPT_GOOD_PERIODS 5          // Good periods before the first step down
+#define ADAPT_MAX_GOOD_PERIODS 60     // Backoff limit for stepping down
+#define ADAPT_FALLBACK_TIME 500       // ms without any ACK before jumping to the top step
+#define ADAPT_FALLBACK_RATE RF24_250KBPS
+#define ADAPT_ANNOUNCE_FRAMES 8       // Frames announcing a data rate change
+
+// One rung of the ladder
+struct AdaptStep {
+  uint8_t dataRate;   // rf24_datarate_e
+  uint8_t paLevel;    // rf24_pa_dbm_e
+  uint8_t retries;    // Auto-retransmit count
+};
+
+const AdaptStep adaptLadder[] = {
+  {RF24_2MBPS,   RF24_PA_MIN,  2},
+  {RF24_2MBPS,   RF24_PA_LOW,  2},
+  {RF24_2MBPS,   RF24_PA_HIGH, 3},
+  {RF24_2MBPS,   RF24_PA_MAX,  3},
+  {RF24_1MBPS,   RF24_PA_MAX,  4},
+  {RF24_250KBPS, RF24_PA_MAX,  5}
+};
+#define ADAPT_STEPS (sizeof(adaptLadder) / sizeof(adaptLadder[0]))
+
+// Adaptation state
+uint8_t adaptStep = 0;
+uint8_t adaptDataRate = RF24_2MBPS;   // Rate on air now (lags adaptStep while announcing)
+uint8_t adaptBoundRate = RF24_2MBPS;
+bool adaptRunning = false;
+bool adaptAnnouncing = false;
+uint32_t adaptSwitchCounter = 0;      // data.counter of the first frame at the new rate
+uint8_t adaptGoodPeriods = 0;
+uint8_t adaptGoodNeeded = ADAPT_GOOD_PERIODS;
+unsigned long lastAdaptDecision = 0;
+uint32_t adaptLastSent = 0;
+uint32_t adaptLastLost = 0;
+uint16_t adaptStepChanges = 0;
+uint16_t adaptFallbacks = 0;
+
+// Forward declare settings getters
+extern bool isLinkAdaptEnabled();
+extern uint8_t getRadioDataRate();
+extern bool isTdmaEnabled();
+
+// Function declarations
+void initLinkAdapt();
+void restartLinkAdapt();
+void updateLinkAdapt();
+void setAdaptStep(uint8_t step);
+bool canAdaptDataRate();
+bool isLinkAdaptActive();
+void checkAdaptSwitch(uint32_t nextCounter);
+bool isAdaptAnnouncing();
+uint8_t getAdaptPALevel();
+uint8_t getAdaptDataRate();
+uint8_t getAdaptRetries();
+
+void initLinkAdapt() {
+  // Start on the most robust step at the bound rate - the receiver boots there
+  adaptBoundRate = getRadioDataRate();
+  adaptDataRate = adaptBoundRate;
+  adaptStep = ADAPT_STEPS - 1;
+  for (uint8_t i = 0; i < ADAPT_STEPS; i++) {
+    if (adaptLadder[i].dataRate == adaptBoundRate && adaptLadder[i].paLevel == RF24_PA_MAX) {
+      adaptStep = i;
+      break;
+    }
+  }
+  adaptAnnouncing = false;
+  adaptGoodPeriods = 0;
+  adaptGoodNeeded = ADAPT_GOOD_PERIODS;
+  lastAdaptDecision = millis();
+  adaptLastSent = linkStats.framesSent;
+  adaptLastLost = linkStats.framesLost;
+}
+
+void restartLinkAdapt() {
+  // Called when the normal link resumes - the gap says nothing about the link
+  uint8_t sreg = SREG;
+  cli();
+  linkStats.lastDelivered = 0;
+  SREG = sreg;
+  initLinkAdapt();
+}
+
+void updateLinkAdapt() {
+  if (!isLinkAdaptActive()) {
+    adaptRunning = false;
+    return;
+  }
+
+  // Restart when switched on, or when a new bound rate means a rebind
+  if (!adaptRunning || getRadioDataRate() != adaptBoundRate) {
+    initLinkAdapt();
+    adaptRunning = true;
+  }
+
+  // Nothing is getting through - the receiver falls back on its own
+  if (linkStats.lastDelivered != 0 && adaptStep != ADAPT_STEPS - 1 &&
+      micros() - linkStats.lastDelivered > ADAPT_FALLBACK_TIME * 1000UL) {
+    adaptStep = ADAPT_STEPS - 1;
+    adaptDataRate = canAdaptDataRate() ? ADAPT_FALLBACK_RATE : adaptBoundRate;
+    adaptAnnouncing = false;
+    adaptGoodPeriods = 0;
+    adaptGoodNeeded = min(adaptGoodNeeded * 2, ADAPT_MAX_GOOD_PERIODS);
+    adaptFallbacks++;
+    // Runs in the transmit path - Serial is not safe from the control ISR
+    if (!CONTROL_ISR) Serial.println("Link adapt: no ACKs - fallback step");
+    return;
+  }
+
+  if (adaptAnnouncing || millis() - lastAdaptDecision < ADAPT_PERIOD) return;
+
+  uint32_t sent = linkStats.framesSent - adaptLastSent;
+  if (sent < ADAPT_MIN_FRAMES) return;
+  uint32_t lost = linkStats.framesLost - adaptLastLost;
+  uint8_t loss = lost * 100 / sent;
+  adaptLastSent = linkStats.framesSent;
+  adaptLastLost = linkStats.framesLost;
+  lastAdaptDecision = millis();
+
+  if (loss > ADAPT_LOSS_HIGH) {
+    uint8_t up = (loss > ADAPT_LOSS_HIGH * 3) ? 2 : 1;
+    adaptGoodPeriods = 0;
+    adaptGoodNeeded = min(adaptGoodNeeded * 2, ADAPT_MAX_GOOD_PERIODS);
+    if (adaptStep < ADAPT_STEPS - 1) setAdaptStep(min(adaptStep + up, (int)ADAPT_STEPS - 1));
+  } else if (loss <= ADAPT_LOSS_TARGET) {
+    if (++adaptGoodPeriods >= adaptGoodNeeded && adaptStep > 0) {
+      adaptGoodPeriods = 0;
+      setAdaptStep(adaptStep - 1);
+    }
+  } else {
+    adaptGoodPeriods = 0;
+  }
+}
+
+void setAdaptStep(uint8_t step) {
+  adaptStep = step;
+  adaptStepChanges++;
+
+  // PA and retries follow at once, a new data rate is announced first
+  uint8_t rate = canAdaptDataRate() ? adaptLadder[step].dataRate : adaptBoundRate;
+  if (rate != adaptDataRate) {
+    adaptAnnouncing = true;
+    adaptSwitchCounter = data.counter + 1 + ADAPT_ANNOUNCE_FRAMES;
+  }
+
+  if (!CONTROL_ISR) {
+    Serial.print("Link adapt: step ");
+    Serial.print(step);
+    Serial.print(" PA ");
+    Serial.print(adaptLadder[step].paLevel);
+    Serial.print(" rate ");
+    Serial.println(rate);
+  }
+}
+
+bool canAdaptDataRate() {
+  return RADIO_PACKET_FORMAT == PACKET_FORMAT_PACKED && !isTdmaEnabled();
+}
+
+bool isLinkAdaptActive() {
+  return RADIO_ACK_TELEMETRY && isLinkAdaptEnabled();
+}
+
+void checkAdaptSwitch(uint32_t nextCounter) {
+  // Called before each frame - the announced frame goes out at the new rate
+  if (!adaptAnnouncing || (int32_t)(nextCounter - adaptSwitchCounter) < 0) return;
+  adaptAnnouncing = false;
+  adaptDataRate = adaptLadder[adaptStep].dataRate;
+  lastAdaptDecision = millis(); // Judge the new rate on a full period
+  adaptLastSent = linkStats.framesSent;
+  adaptLastLost = linkStats.framesLost;
+}
+
+bool isAdaptAnnouncing() {
+  return adaptAnnouncing;
+}
+
+uint8_t getAdaptPALevel() {
+  return adaptLadder[adaptStep].paLevel;
+}
+
+uint8_t getAdaptDataRate() {
+  return adaptDataRate;
+}
+
+uint8_t getAdaptRetries() {
+  return adaptLadder[adaptStep].retries;
+}
+
+#endif
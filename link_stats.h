@@ -0,0 +1,237 @@
+/*
+  link_stats.h - Rolling link-quality statistics
+  RC Transmitter for Arduino Mega
+
+  Fed by radio.h with one result per frame (write result or IRQ completion)
+  plus the ARC retry count. The nRF24 PLOS counter is not exposed by the
+  RF24 library and resets on every channel write (hopping), so lost frames
+  are counted here from MAX_RT events instead.
+
+  Without auto-ack every frame that leaves the chip counts as delivered, so
+  loss and retries are only meaningful with RADIO_ACK_TELEMETRY - rate and
+  gap figures are valid either way.
+
+  Per-slot figures (tdma.h) are taken when a frame is queued for a slot:
+  the update rate each receiver gets, its longest update interval and the
+  jitter (longest minus shortest interval) over the last period.
+
+  Radio recovery events from radio_health.h are kept here too, together
+  with the lost / skipped streaks the health monitor watches.
+*/
+
+#ifndef LINK_STATS_H
+#define LINK_STATS_H
+
+#include <Arduino.h>
+#include "tdma.h"
+
+// Link stats constants
+#define LINK_STATS_WINDOW 64        // Frames in the rolling loss window
+#define LINK_STATS_PERIOD 1000      // ms per rate / gap measurement window
+
+// Link statistics
+struct LinkStats {
+  // Rolling loss window (1 bit per frame, 1 = lost)
+  uint8_t lossBits[LINK_STATS_WINDOW / 8];
+  uint8_t windowPos;
+  uint8_t windowFill;
+  uint8_t windowLost;
+
+  // Totals since boot
+  uint32_t framesSent;
+  uint32_t framesLost;
+  uint32_t framesSkipped;     // Never reached the air (FIFO full / deferred)
+  uint32_t totalRetries;
+
+  // Per-period figures (updated every LINK_STATS_PERIOD)
+  uint16_t framesThisPeriod;
+  uint16_t retriesThisPeriod;
+  unsigned long periodStart;
+  unsigned long worstGapThisPeriod;
+  uint16_t effectiveRate;     // Delivered frames per second (last period)
+  uint16_t retriesPerSecond;  // ARC retries per second (last period)
+  unsigned long worstGap;     // Longest gap between delivered frames (last period, us)
+  unsigned long worstGapEver; // Longest gap since boot (us)
+  unsigned long lastDelivered;
+  
+  // Airtime (frames that left the chip, redundancy share separately)
+  uint32_t bytesSent;
+  uint32_t redundantBytes;    // Delta blocks and parity frames
+  unsigned long airtimeThisPeriod;
+  unsigned long redundantAirtimeThisPeriod;
+  uint16_t airtimePermille;   // Share of the last period spent on air (1/1000)
+  uint16_t redundantPermille; // Part of that spent on redundancy (1/1000)
+
+  // Streaks since the last delivered frame (radio_health.h)
+  uint16_t failStreak;        // Frames lost in a row
+  uint16_t skipStreak;        // Ticks skipped in a row without any completion
+
+  // Radio recovery events (radio_health.h)
+  uint16_t radioFaults;
+  uint16_t radioRecoveries;
+  unsigned long lastFaultAt;        // millis() of the last fault
+  unsigned long lastRecoveryTime;   // Fault to working chip (ms)
+  unsigned long worstRecoveryTime;
+};
+
+LinkStats linkStats;
+
+// Per-slot update statistics (one receiver per slot)
+struct SlotStats {
+  uint16_t framesThisPeriod;
+  unsigned long lastSent;
+  unsigned long minIntervalThisPeriod;
+  unsigned long maxIntervalThisPeriod;
+  uint16_t rate;              // Frames per second (last period)
+  unsigned long worstInterval; // Longest update interval (last period, us)
+  unsigned long jitter;       // Longest minus shortest interval (last period, us)
+  uint32_t skipped;           // Slot ticks that could not send
+};
+
+SlotStats slotStats[TDMA_MAX_SLOTS];
+
+// Function declarations
+void resetLinkStats();
+void recordTxResult(bool delivered, uint8_t retries, unsigned long completedAt);
+void recordTxSkipped();
+void recordRadioFault();
+void recordRadioRecovered(unsigned long downtime);
+void recordTxAirtime(uint8_t length, uint8_t redundant, uint16_t airtime);
+void updateLinkStats();
+uint8_t getLinkLossPercent();
+void recordSlotSent(uint8_t slot, unsigned long sentAt);
+void recordSlotSkipped(uint8_t slot);
+void resetSlotPeriod(SlotStats &slot);
+
+void resetLinkStats() {
+  memset(&linkStats, 0, sizeof(linkStats));
+  linkStats.periodStart = millis();
+  memset(slotStats, 0, sizeof(slotStats));
+  for (uint8_t i = 0; i < TDMA_MAX_SLOTS; i++) resetSlotPeriod(slotStats[i]);
+}
+
+void recordTxResult(bool delivered, uint8_t retries, unsigned long completedAt) {
+  LinkStats &s = linkStats;
+
+  // Drop the oldest bit out of the window before writing the new one
+  uint8_t mask = 1 << (s.windowPos & 7);
+  uint8_t &cell = s.lossBits[s.windowPos >> 3];
+  if (s.windowFill == LINK_STATS_WINDOW) {
+    if (cell & mask) s.windowLost--;
+  } else {
+    s.windowFill++;
+  }
+  if (delivered) {
+    cell &= ~mask;
+  } else {
+    cell |= mask;
+    s.windowLost++;
+  }
+  s.windowPos = (s.windowPos + 1) % LINK_STATS_WINDOW;
+
+  s.framesSent++;
+  s.totalRetries += retries;
+  s.skipStreak = 0;
+  if (delivered) {
+    s.failStreak = 0;
+  } else if (s.failStreak < 0xFFFF) {
+    s.failStreak++;
+  }
+  s.retriesThisPeriod += retries;
+
+  if (delivered) {
+    s.framesThisPeriod++;
+
+    if (s.lastDelivered != 0) {
+      unsigned long gap = completedAt - s.lastDelivered;
+      if (gap > s.worstGapThisPeriod) s.worstGapThisPeriod = gap;
+      if (gap > s.worstGapEver) s.worstGapEver = gap;
+    }
+    s.lastDelivered = completedAt;
+  } else {
+    s.framesLost++;
+  }
+}
+
+void recordTxSkipped() {
+  linkStats.framesSkipped++;
+  if (linkStats.skipStreak < 0xFFFF) linkStats.skipStreak++;
+}
+
+void recordRadioFault() {
+  linkStats.radioFaults++;
+  linkStats.lastFaultAt = millis();
+}
+
+void recordRadioRecovered(unsigned long downtime) {
+  LinkStats &s = linkStats;
+  s.radioRecoveries++;
+  s.lastRecoveryTime = downtime;
+  if (downtime > s.worstRecoveryTime) s.worstRecoveryTime = downtime;
+  s.failStreak = 0;
+  s.skipStreak = 0;
+}
+
+void recordTxAirtime(uint8_t length, uint8_t redundant, uint16_t airtime) {
+  LinkStats &s = linkStats;
+  s.bytesSent += length;
+  s.redundantBytes += redundant;
+  s.airtimeThisPeriod += airtime;
+  if (length > 0) s.redundantAirtimeThisPeriod += (uint32_t)airtime * redundant / length;
+}
+
+void recordSlotSent(uint8_t slot, unsigned long sentAt) {
+  SlotStats &s = slotStats[slot];
+  if (s.lastSent != 0) {
+    unsigned long interval = sentAt - s.lastSent;
+    if (interval < s.minIntervalThisPeriod) s.minIntervalThisPeriod = interval;
+    if (interval > s.maxIntervalThisPeriod) s.maxIntervalThisPeriod = interval;
+  }
+  s.lastSent = sentAt;
+  s.framesThisPeriod++;
+}
+
+void recordSlotSkipped(uint8_t slot) {
+  slotStats[slot].skipped++;
+}
+
+void resetSlotPeriod(SlotStats &slot) {
+  slot.framesThisPeriod = 0;
+  slot.minIntervalThisPeriod = 0xFFFFFFFFUL;
+  slot.maxIntervalThisPeriod = 0;
+}
+
+void updateLinkStats() {
+  LinkStats &s = linkStats;
+  unsigned long elapsed = millis() - s.periodStart;
+  if (elapsed < LINK_STATS_PERIOD) return;
+
+  s.effectiveRate = (uint32_t)s.framesThisPeriod * 1000 / elapsed;
+  s.retriesPerSecond = (uint32_t)s.retriesThisPeriod * 1000 / elapsed;
+  s.worstGap = s.worstGapThisPeriod;
+  s.airtimePermille = s.airtimeThisPeriod / elapsed;   // us per ms
+  s.redundantPermille = s.redundantAirtimeThisPeriod / elapsed;
+
+  s.framesThisPeriod = 0;
+  s.retriesThisPeriod = 0;
+  s.worstGapThisPeriod = 0;
+  s.airtimeThisPeriod = 0;
+  s.redundantAirtimeThisPeriod = 0;
+  
+  for (uint8_t i = 0; i < TDMA_MAX_SLOTS; i++) {
+    SlotStats &slot = slotStats[i];
+    slot.rate = (uint32_t)slot.framesThisPeriod * 1000 / elapsed;
+    slot.worstInterval = slot.maxIntervalThisPeriod;
+    slot.jitter = slot.maxIntervalThisPeriod >= slot.minIntervalThisPeriod ?
+                  slot.maxIntervalThisPeriod - slot.minIntervalThisPeriod : 0;
+    resetSlotPeriod(slot);
+  }
+  s.periodStart = millis();
+}
+
+uint8_t getLinkLossPercent() {
+  if (linkStats.windowFill == 0) return 0;
+  return (uint16_t)linkStats.windowLost * 100 / linkStats.windowFill;
+}
+
+#endif
@@ -13,6 +13,11 @@
 #include "menu_display.h"
 #include "menu_settings.h"
 #include "menu_calibration.h"
+#include "scanner.h"
+#include "bind.h"
+#include "ping.h"
+#include "radio_test.h"
+#include "trace.h"
 
 // Menu navigation variables - declare extern where used in other files
 MenuState currentMenu = MENU_HIDDEN;
@@ -46,11 +51,16 @@ void handleCancelConfirmation();
 int getNavigationDirection();
 bool isMenuActive();
 void drawMenu();
+bool isLinkPaused();
 
 // Forward declaration for the lockout check
 extern bool isInSettingLockout();
 extern void drawSettingSaveScreen();
 
+// Forward declare radio sections (fast_disarm.h)
+extern void beginRadioUse();
+extern void endRadioUse();
+
 void initMenu() {
   Serial.println("Initializing menu system...");
   
@@ -63,9 +73,11 @@ void initMenu() {
 }
 
 void updateMenu() {
+  TRACE_BEGIN(TRACE_MENU);
   // Handle cancel confirmation first
   if (cancelConfirmActive) {
     handleCancelConfirmation();
+    TRACE_END(TRACE_MENU);
     return;
   }
   
@@ -73,6 +85,7 @@ void updateMenu() {
   if (buttons.rightJoyBtn && millis() - lastNavigation > NAV_DEBOUNCE) {
     if (currentMenu != MENU_MAIN && currentMenu != MENU_HIDDEN) {
       showCancelConfirm();
+      TRACE_END(TRACE_MENU);
       return;
     }
   }
@@ -89,7 +102,7 @@ void updateMenu() {
         enterMenu();
         Serial.println("OK pressed from homepage - entering menu");
         lastNavigation = millis();
-      } else if (!isSettingActive() && !isCalibrationActive()) {
+      } else if (!isSettingActive() && !isCalibrationActive() && !isScannerActive() && !isBindActive() && !isPingActive() && !isRadioTestActive()) {
         // Only handle menu selection if we're not in setting or calibration mode
         // In those modes, let their respective handlers deal with OK button
         if (!isInSettingLockout()) {
@@ -114,6 +127,22 @@ void updateMenu() {
       updateMenuCalibration();
     } else if (isSettingActive()) {
       updateMenuSettings();
+    } else if (isScannerActive()) {
+      // Menu tools bracket their own radio use - the rest of the menu
+      // (EEPROM saves included) never holds the radio
+      beginRadioUse();
+      updateScanner();
+      endRadioUse();
+    } else if (isBindActive()) {
+      beginRadioUse();
+      updateBind();
+      endRadioUse();
+    } else if (isPingActive()) {
+      updatePing();
+    } else if (isRadioTestActive()) {
+      beginRadioUse();
+      updateRadioTest();
+      endRadioUse();
     } else {
       // CRITICAL FIX: Only handle navigation if not in setting lockout
       if (!isInSettingLockout()) {
@@ -126,6 +155,7 @@ void updateMenu() {
       exitMenu();
     }
   }
+  TRACE_END(TRACE_MENU);
 }
 
 void handleMenuNavigation() {
@@ -225,6 +255,12 @@ void exitMenu() {
   menuActive = false;
   exitMenuCalibration();
   exitMenuSettings();
+  beginRadioUse();
+  stopScanner();
+  stopBind();
+  stopPing();
+  stopRadioTest();
+  endRadioUse();
   cancelConfirmActive = false;
   menuSelection = 0;
   menuOffset = 0;
@@ -261,8 +297,9 @@ void goBack() {
       break;
     case MENU_LED_SETTINGS:
     case MENU_FAILSAFE_SETTINGS:
+    case MENU_LINK_SETTINGS:
       currentMenu = MENU_SETTINGS;
-      maxMenuItems = 8;
+      maxMenuItems = 9;
       break;
     default:
       // Let subsystems handle their own back navigation
@@ -296,11 +333,17 @@ void selectMenuItem() {
           break;
         case 1: // Settings
           currentMenu = MENU_SETTINGS;
-          maxMenuItems = 8;
+          maxMenuItems = 9;
           break;
         case 2: // System Info
           currentMenu = MENU_INFO;
-          maxMenuItems = 3;
+          maxMenuItems = 11 + PROF_INFO_ITEMS;
+          break;
+        case 3: // Radio Test - transmission pauses while it runs
+          beginRadioUse();
+          startRadioTest();
+          endRadioUse();
+          if (isRadioTestRunning()) currentMenu = MENU_RADIO_TEST;
           break;
         case 6: // Exit
           exitMenu();
@@ -359,8 +402,12 @@ void selectMenuItem() {
           currentMenu = MENU_FAILSAFE_SETTINGS; 
           maxMenuItems = 4; // Updated to 4 since we removed test failsafe
           break;
-        case 6: resetAllSettings(); break;
-        case 7: goBack(); return;
+        case 6: 
+          currentMenu = MENU_LINK_SETTINGS; 
+          maxMenuItems = 14; 
+          break;
+        case 7: resetAllSettings(); break;
+        case 8: goBack(); return;
       }
       break;
       
@@ -374,6 +421,11 @@ void selectMenuItem() {
       if (menuSelection == 3) goBack(); // Back option (now index 3 instead of 4)
       return;
       
+    case MENU_LINK_SETTINGS:
+      handleLinkSettingsSelection(menuSelection);
+      if (menuSelection == 13) goBack(); // Back option
+      return;
+      
     case MENU_INFO:
       if (menuSelection == maxMenuItems - 1) {
         goBack();
@@ -391,6 +443,11 @@ bool isMenuActive() {
   return menuActive;
 }
 
+// True while a menu tool (scanner, bind, radio test) has taken the radio off the control link
+bool isLinkPaused() {
+  return isScannerActive() || isBinding() || isRadioTestRunning();
+}
+
 // Main display function - delegates to appropriate subsystem
 void drawMenu() {
   if (currentMenu == MENU_HIDDEN) return;
@@ -406,11 +463,20 @@ void drawMenu() {
     drawMenuCalibration();
   } else if (isSettingActive()) {
     drawMenuSettings();
+  } else if (isScannerActive()) {
+    drawScanner();
+  } else if (isBindActive()) {
+    drawBind();
+  } else if (isPingActive()) {
+    drawPing();
+  } else if (isRadioTestActive()) {
+    drawRadioTest();
   } else {
     drawMainMenus();
   }
   
-  display.display();
+  // Sent in chunks by the scheduler (display.h)
+  startDisplayPush();
 }
 
 #endif
\ No newline at end of file
@@ -8,6 +8,8 @@
 
 #include <EEPROM.h>
 #include "config.h"
+#include "tdma.h"
+#include "trace.h"
 
 // Menu states
 enum MenuState {
@@ -27,6 +29,13 @@ enum MenuState {
   MENU_FAILSAFE_THROTTLE_SETTING,  // New
   MENU_FAILSAFE_STEERING_SETTING,  // New
   MENU_CHANNEL_SETTINGS,
+  MENU_LINK_SETTINGS,
+  MENU_MIN_RATE_SETTING,
+  MENU_MAX_RATE_SETTING,
+  MENU_SPECTRUM_SCAN,
+  MENU_BIND,
+  MENU_PING,
+  MENU_RADIO_TEST,
   MENU_INFO,
   MENU_CAL_IN_PROGRESS,
   MENU_CANCEL_CONFIRM
@@ -81,12 +90,30 @@ struct SettingsData {
   // Radio settings
   char radioAddress[6];       // 5 characters + null terminator
   int radioChannel;           // 0-125
+  uint32_t txId;              // Unique transmitter ID, sent to the receiver on bind
+  uint8_t paLevel;            // rf24_pa_dbm_e: MIN, LOW, HIGH, MAX
+  uint8_t dataRate;           // rf24_datarate_e: 1M, 2M, 250K (receiver must match)
+  bool linkAdaptEnabled;      // link_adapt.h picks PA level, data rate and retries
+  uint8_t outputMode;         // OUTPUT_RADIO / PPM / SBUS / CRSF bitmask
   
   // Failsafe settings
   int failsafeThrottle;       // -1000 to 1000
   int failsafeSteering;       // -1000 to 1000
   bool failsafeEnabled;
   
+  // Packet rate settings
+  int minPacketRate;          // 5-50 Hz keep-alive rate when sticks are static
+  int maxPacketRate;          // 50-500 Hz rate while sticks are moving
+  
+  // Frequency hopping settings
+  bool hoppingEnabled;
+  uint16_t hopSeed;           // Seed for the hop table (shared with receiver)
+  int hopInterval;            // Packets per hop: 1, 2, 4 or 8
+  
+  // Time-slotted multi-receiver settings
+  uint8_t tdmaSlots;          // Receivers served in turn: 1 (off) to TDMA_MAX_SLOTS
+  uint8_t tdmaMix[TDMA_MAX_SLOTS]; // TdmaMix for each slot
+  
   // EEPROM signature
   uint16_t signature;
 };
@@ -126,11 +153,13 @@ CalibrationData calData;
 #define EEPROM_CAL_ADDRESS 0
 #define EEPROM_SETTINGS_ADDRESS 512
 #define EEPROM_SIGNATURE 0xCAFE
+#define EEPROM_SETTINGS_SIGNATURE 0xCB01 // Bump whenever SettingsData changes layout
 
 // Function declarations
 void initMenuData();
 void saveSettings();
 void loadSettings();
+bool validateSettings();
 void resetSettings();
 void saveCalibration();
 void loadCalibration();
@@ -138,6 +167,21 @@ void resetCalibration();
 void applyLEDSettings();
 void applyDisplayBrightness();
 int getCurrentDeadzone();
+int getMinPacketRate();
+int getMaxPacketRate();
+bool isHoppingEnabled();
+uint16_t getHopSeed();
+int getHopInterval();
+uint8_t getRadioChannel();
+const char* getRadioAddress();
+uint8_t getRadioPALevel();
+uint8_t getRadioDataRate();
+bool isLinkAdaptEnabled();
+uint8_t getOutputMode();
+bool isRadioOutputEnabled();
+uint8_t getTdmaSlots();
+uint8_t getTdmaMix(uint8_t slot);
+uint32_t generateTxId();
 String getCalibrationStatus(String axis);
 int getCalibratedValue(int rawValue, int minVal, int neutralVal, int maxVal);
 int getCalibratedSteering();
@@ -163,8 +207,10 @@ void initMenuData() {
 }
 
 void saveSettings() {
-  settings.signature = EEPROM_SIGNATURE;
+  settings.signature = EEPROM_SETTINGS_SIGNATURE;
+  TRACE_BEGIN(TRACE_SAVE_SETTINGS);
   EEPROM.put(EEPROM_SETTINGS_ADDRESS, settings);
+  TRACE_END(TRACE_SAVE_SETTINGS);
   Serial.println("Settings saved to EEPROM");
   
   // Apply settings immediately after saving
@@ -175,9 +221,13 @@ void saveSettings() {
 void loadSettings() {
   EEPROM.get(EEPROM_SETTINGS_ADDRESS, settings);
   
-  if (settings.signature != EEPROM_SIGNATURE) {
+  if (settings.signature != EEPROM_SETTINGS_SIGNATURE) {
     Serial.println("No valid settings found, using defaults");
     resetSettings();
+  } else if (!validateSettings()) {
+    // Out-of-range values would divide by zero or index past the slot arrays
+    Serial.println("Settings out of range, using defaults");
+    resetSettings();
   } else {
     Serial.println("Settings loaded from EEPROM");
   }
@@ -197,20 +247,66 @@ void resetSettings() {
   settings.ledMenuColor[0] = true; settings.ledMenuColor[1] = false; settings.ledMenuColor[2] = true; // Magenta
   
   // Default radio settings
-  strcpy(settings.radioAddress, "BOAT1");
-  settings.radioChannel = 76;
+  strcpy(settings.radioAddress, RADIO_ADDRESS);
+  settings.radioChannel = RADIO_CHANNEL;
+  settings.paLevel = RF24_PA_HIGH;
+  settings.dataRate = RF24_2MBPS;
+  settings.linkAdaptEnabled = true;
+  settings.outputMode = OUTPUT_RADIO;
+  
+  // Keep an existing TX ID across resets so bound receivers still match
+  if (settings.txId == 0 || settings.txId == 0xFFFFFFFFUL) {
+    settings.txId = generateTxId();
+  }
   
   // Default failsafe settings
   settings.failsafeThrottle = 0;
   settings.failsafeSteering = 0;
   settings.failsafeEnabled = true;
   
-  settings.signature = EEPROM_SIGNATURE;
+  // Default packet rate settings
+  settings.minPacketRate = 10;
+  settings.maxPacketRate = 250;
+  
+  // Default hopping settings - off until the receiver is set up for it
+  settings.hoppingEnabled = false;
+  settings.hopSeed = 0x5EED;
+  settings.hopInterval = 4;
+  
+  // Default TDMA settings - one receiver, second boat on the aux sticks
+  settings.tdmaSlots = 1;
+  settings.tdmaMix[0] = TDMA_MIX_MAIN;
+  settings.tdmaMix[1] = TDMA_MIX_AUX;
+  settings.tdmaMix[2] = TDMA_MIX_NEUTRAL;
+  settings.tdmaMix[3] = TDMA_MIX_NEUTRAL;
+  
+  settings.signature = EEPROM_SETTINGS_SIGNATURE;
+}
+
+bool validateSettings() {
+  // Same ranges the settings menu allows
+  if (settings.joystickDeadzone < 0 || settings.joystickDeadzone > 200) return false;
+  if (settings.displayBrightness < 0 || settings.displayBrightness > 255) return false;
+  if (settings.radioAddress[5] != '\0') return false;
+  if (settings.radioChannel < 0 || settings.radioChannel > 125) return false;
+  if (settings.paLevel > RF24_PA_MAX || settings.dataRate > RF24_250KBPS) return false;
+  if (settings.outputMode == 0 || settings.outputMode > (OUTPUT_RADIO | OUTPUT_PPM | OUTPUT_SBUS | OUTPUT_CRSF)) return false;
+  if (settings.minPacketRate < 5 || settings.minPacketRate > 50) return false;
+  if (settings.maxPacketRate < settings.minPacketRate || settings.maxPacketRate > 500) return false;
+  if (settings.hopInterval != 1 && settings.hopInterval != 2 &&
+      settings.hopInterval != 4 && settings.hopInterval != 8) return false;
+  if (settings.tdmaSlots < 1 || settings.tdmaSlots > TDMA_MAX_SLOTS) return false;
+  for (uint8_t i = 0; i < TDMA_MAX_SLOTS; i++) {
+    if (settings.tdmaMix[i] >= TDMA_MIX_COUNT) return false;
+  }
+  return true;
 }
 
 void saveCalibration() {
   calData.signature = EEPROM_SIGNATURE;
+  TRACE_BEGIN(TRACE_SAVE_CALIBRATION);
   EEPROM.put(EEPROM_CAL_ADDRESS, calData);
+  TRACE_END(TRACE_SAVE_CALIBRATION);
   Serial.println("Calibration saved to EEPROM");
 }
 
@@ -301,6 +397,76 @@ int getCurrentDeadzone() {
   return settings.joystickDeadzone;
 }
 
+int getMinPacketRate() {
+  return settings.minPacketRate;
+}
+
+int getMaxPacketRate() {
+  return settings.maxPacketRate;
+}
+
+bool isHoppingEnabled() {
+  return settings.hoppingEnabled;
+}
+
+uint16_t getHopSeed() {
+  return settings.hopSeed;
+}
+
+int getHopInterval() {
+  return settings.hopInterval;
+}
+
+uint8_t getRadioChannel() {
+  return settings.radioChannel;
+}
+
+const char* getRadioAddress() {
+  return settings.radioAddress;
+}
+
+uint8_t getRadioPALevel() {
+  return settings.paLevel;
+}
+
+uint8_t getRadioDataRate() {
+  return settings.dataRate;
+}
+
+bool isLinkAdaptEnabled() {
+  return settings.linkAdaptEnabled;
+}
+
+uint8_t getOutputMode() {
+  // Never all off - fall back to the radio. Serial1 carries one protocol
+  uint8_t mode = settings.outputMode & (OUTPUT_RADIO | OUTPUT_PPM | OUTPUT_SBUS | OUTPUT_CRSF);
+  if ((mode & OUTPUT_SBUS) && (mode & OUTPUT_CRSF)) mode &= ~OUTPUT_CRSF;
+  return mode ? mode : OUTPUT_RADIO;
+}
+
+bool isRadioOutputEnabled() {
+  return getOutputMode() & OUTPUT_RADIO;
+}
+
+uint8_t getTdmaSlots() {
+  return constrain(settings.tdmaSlots, 1, TDMA_MAX_SLOTS);
+}
+
+uint8_t getTdmaMix(uint8_t slot) {
+  return slot < TDMA_MAX_SLOTS ? settings.tdmaMix[slot] : TDMA_MIX_NEUTRAL;
+}
+
+uint32_t generateTxId() {
+  // Mix ADC noise and timing jitter - there is no hardware RNG on the Mega
+  uint32_t seed = micros();
+  for (uint8_t i = 0; i < 16; i++) {
+    seed = (seed << 3) ^ (seed >> 29) ^ analogRead(i & 1 ? RIGHT_POT : LEFT_POT) ^ micros();
+  }
+  randomSeed(seed);
+  uint32_t id = ((uint32_t)random(0x10000) << 16) | random(0x10000);
+  return (id == 0 || id == 0xFFFFFFFFUL) ? 0x1234567UL : id;
+}
+
 String getCalibrationStatus(String axis) {
   if (axis == "RIGHT_X") return calData.rightJoyX_calibrated ? "[OK]" : "[--]";
   if (axis == "RIGHT_Y") return calData.rightJoyY_calibrated ? "[OK]" : "[--]";
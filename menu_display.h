@@ -9,6 +9,7 @@
 #include "config.h"
 #include "display.h"
 #include "menu_data.h"
+#include "profiler.h"
 
 // Display constants
 #define MENU_ITEM_HEIGHT 12
@@ -16,6 +17,18 @@
 #define SCROLLBAR_WIDTH 4
 #define SCROLLBAR_X 124
 
+// Radio setting labels, indexed by rf24_pa_dbm_e / rf24_datarate_e
+const char* const paLevelNames[] = {"MIN", "LOW", "HIGH", "MAX"};
+const char* const dataRateNames[] = {"1M", "2M", "250K"};
+// Output choices offered by Link Settings > Output, in cycle order
+const uint8_t outputModeChoices[OUTPUT_MODE_CHOICES] = {
+  OUTPUT_RADIO, OUTPUT_PPM, OUTPUT_RADIO | OUTPUT_PPM,
+  OUTPUT_SBUS, OUTPUT_RADIO | OUTPUT_SBUS, OUTPUT_CRSF, OUTPUT_RADIO | OUTPUT_CRSF
+};
+const char* const outputModeNames[OUTPUT_MODE_CHOICES] = {
+  "RF", "PPM", "RF+PPM", "SBUS", "RF+SBUS", "CRSF", "RF+CRSF"
+};
+
 // External variables from menu.h
 extern int menuSelection;
 extern int menuOffset;
@@ -30,6 +43,9 @@ void drawMainMenus();
 void drawScrollableMenu(MenuItem* items, int itemCount, String header);
 void drawScrollbar(int totalItems, int visibleItems, int offset);
 void drawCancelConfirmation();
+uint8_t getOutputModeChoice();
+String getSlotRatesText();
+String getLinkAdaptText();
 
 void drawMainMenus() {
   switch (currentMenu) {
@@ -38,7 +54,7 @@ void drawMainMenus() {
         {"Calibration", true, true},
         {"Settings", true, true},
         {"System Info", true, true},
-        {"Radio Test", true, false},
+        {"Radio Test", true, true},
         {"Display Test", true, false},
         {"Factory Reset", true, false},
         {"Exit", true, false}
@@ -88,10 +104,11 @@ void drawMainMenus() {
         {"Radio Address", true, false},
         {"Radio Channel", true, false},
         {"Failsafe Settings", true, true},
+        {"Link Settings", true, true},
         {"Reset to Defaults", true, false},
         {"Back", true, false}
       };
-      drawScrollableMenu(items, 8, "Settings");
+      drawScrollableMenu(items, 9, "Settings");
       break;
     }
     
@@ -120,13 +137,52 @@ void drawMainMenus() {
       break;
     }
     
+    case MENU_LINK_SETTINGS: {
+      MenuItem items[] = {
+        {"Min Rate: " + String(settings.minPacketRate) + "Hz", true, false},
+        {"Max Rate: " + String(settings.maxPacketRate) + "Hz", true, false},
+        {"Hopping: " + String(!settings.hoppingEnabled ? "OFF" : settings.tdmaSlots > 1 ? "TDMA" : "ON"), true, false},
+        {"Hop Every: " + String(settings.hopInterval) + " pkt", true, false},
+        {"Hop Seed: " + String(settings.hopSeed, HEX), true, false},
+        {"PA Level: " + String(paLevelNames[settings.paLevel & 3]), true, false},
+        {"Data Rate: " + String(dataRateNames[settings.dataRate % 3]), true, false},
+        {"Auto Link: " + String(settings.linkAdaptEnabled ? "ON" : "OFF"), true, false},
+        {"Boats: " + String(settings.tdmaSlots) + String(settings.tdmaSlots > 1 ? " (TDMA)" : ""), true, false},
+        {"Output: " + String(outputModeNames[getOutputModeChoice()]), true, false},
+        {"Ping Test", true, true},
+        {"Spectrum Scan", true, true},
+        {"Bind Receiver", true, true},
+        {"Back", true, false}
+      };
+      drawScrollableMenu(items, 14, "Link Settings");
+      break;
+    }
+    
     case MENU_INFO: {
       MenuItem items[] = {
         {"Firmware v3.0", false, false},
         {"Free Memory: " + String(freeMemory()), false, false},
+        {"Packets: " + String(uiSnapshot.data.counter), false, false},
+        {"Rate: " + String(linkStats.effectiveRate) + "/" + String(getCurrentPacketRate()) + "Hz", false, false},
+        {"Loss: " + String(getLinkLossPercent()) + "% (" + String(linkStats.framesLost) + ")", false, false},
+        {"Retries/s: " + String(linkStats.retriesPerSecond), false, false},
+        {"Gap: " + String(linkStats.worstGap / 1000) + "/" + String(linkStats.worstGapEver / 1000) + "ms", false, false},
+        {"Skipped: " + String(linkStats.framesSkipped), false, false},
+        {"Slots: " + getSlotRatesText(), false, false},
+        {"Auto: " + getLinkAdaptText(), false, false},
+#if PROFILER
+        {"Loop: " + String(profLoopRate) + "Hz", false, false},
+        {getProfileText(PROF_LOOP), false, false},
+        {getProfileText(PROF_BUTTONS), false, false},
+        {getProfileText(PROF_JOYSTICKS), false, false},
+        {getProfileText(PROF_TRANSMIT), false, false},
+        {getProfileText(PROF_MENU), false, false},
+        {getProfileText(PROF_DISPLAY), false, false},
+        {getProfileText(PROF_DISPLAY_PUSH), false, false},
+#endif
         {"Back", true, false}
       };
-      drawScrollableMenu(items, 3, "System Info");
+      drawScrollableMenu(items, 11 + PROF_INFO_ITEMS, "System Info");
       break;
     }
   }
@@ -216,4 +272,31 @@ void drawCancelConfirmation() {
   display.setTextColor(SSD1306_WHITE);
 }
 
+String getSlotRatesText() {
+  // Update rate each receiver got over the last second, e.g. "50/50Hz"
+  if (settings.tdmaSlots <= 1) return "off";
+  String text = "";
+  for (uint8_t i = 0; i < settings.tdmaSlots && i < TDMA_MAX_SLOTS; i++) {
+    if (i > 0) text += "/";
+    text += String(slotStats[i].rate);
+  }
+  return text + "Hz";
+}
+
+String getLinkAdaptText() {
+  // Radio settings the adaptation engine is using, e.g. "3 2M MAX"
+  if (!isLinkAdaptActive()) return "off";
+  return String(adaptStep) + " " + dataRateNames[getAdaptDataRate() % 3] + " " +
+         paLevelNames[getAdaptPALevel() & 3] + (isAdaptAnnouncing() ? "*" : "");
+}
+
+uint8_t getOutputModeChoice() {
+  // Index into outputModeChoices - combinations the menu does not offer show as RF
+  uint8_t mode = getOutputMode();
+  for (uint8_t i = 0; i < OUTPUT_MODE_CHOICES; i++) {
+    if (outputModeChoices[i] == mode) return i;
+  }
+  return 0;
+}
+
 #endif
\ No newline at end of file
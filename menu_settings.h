@@ -52,6 +52,16 @@ extern unsigned long menuTimer;
 // Forward declarations for external functions
 extern ButtonStates buttons;
 extern int getNavigationDirection();
+extern void startScanner();
+extern bool isScannerActive();
+extern void startBind();
+extern bool isBinding();
+extern void startPing();
+extern void beginRadioUse();
+extern void endRadioUse();
+extern const uint8_t outputModeChoices[];
+extern const char* const outputModeNames[];
+extern uint8_t getOutputModeChoice();
 
 // Function declarations
 void initMenuSettings();
@@ -65,6 +75,7 @@ void exitMenuSettings();
 void goBackSettings();
 void handleLEDSettingsSelection(int selection);
 void handleFailsafeSettingsSelection(int selection);
+void handleLinkSettingsSelection(int selection);
 void resetAllSettings();
 void drawMenuSettings();
 void drawSettingScreen();
@@ -258,6 +269,18 @@ void handleSettingNavigation() {
       } else if (navDirection == -2 || navDirection == -1) { // Left or Up - decrease
         settings.radioChannel = max(0, settings.radioChannel - (rapidChangeActive ? 5 : 1));
       }
+    } else if (currentMenu == MENU_MIN_RATE_SETTING) {
+      if (navDirection == 2 || navDirection == 1) { // Right or Down - increase
+        settings.minPacketRate = min(min(50, settings.maxPacketRate), settings.minPacketRate + (rapidChangeActive ? 5 : 1));
+      } else if (navDirection == -2 || navDirection == -1) { // Left or Up - decrease
+        settings.minPacketRate = max(5, settings.minPacketRate - (rapidChangeActive ? 5 : 1));
+      }
+    } else if (currentMenu == MENU_MAX_RATE_SETTING) {
+      if (navDirection == 2 || navDirection == 1) { // Right or Down - increase
+        settings.maxPacketRate = min(500, settings.maxPacketRate + (rapidChangeActive ? 50 : 10));
+      } else if (navDirection == -2 || navDirection == -1) { // Left or Up - decrease
+        settings.maxPacketRate = max(max(50, settings.minPacketRate), settings.maxPacketRate - (rapidChangeActive ? 50 : 10));
+      }
     } else if (currentMenu == MENU_FAILSAFE_THROTTLE_SETTING) {
       if (navDirection == 2 || navDirection == 1) { // Right or Down - increase
         settings.failsafeThrottle = min(1000, settings.failsafeThrottle + (rapidChangeActive ? 50 : 10));
@@ -348,6 +371,10 @@ void startSetting(String settingType) {
     keyboardInput = String(settings.radioAddress);
   } else if (settingType == "CHANNEL") {
     currentMenu = MENU_CHANNEL_SETTINGS;
+  } else if (settingType == "MIN_RATE") {
+    currentMenu = MENU_MIN_RATE_SETTING;
+  } else if (settingType == "MAX_RATE") {
+    currentMenu = MENU_MAX_RATE_SETTING;
   } else if (settingType == "FAILSAFE_THROTTLE") {
     currentMenu = MENU_FAILSAFE_THROTTLE_SETTING;
   } else if (settingType == "FAILSAFE_STEERING") {
@@ -378,9 +405,12 @@ void completeSetting() {
   if (currentMenu == MENU_FAILSAFE_THROTTLE_SETTING || currentMenu == MENU_FAILSAFE_STEERING_SETTING) {
     currentMenu = MENU_FAILSAFE_SETTINGS;
     maxMenuItems = 4; // Updated to 4 since we removed test failsafe
+  } else if (currentMenu == MENU_MIN_RATE_SETTING || currentMenu == MENU_MAX_RATE_SETTING) {
+    currentMenu = MENU_LINK_SETTINGS;
+    maxMenuItems = 14;
   } else {
     currentMenu = MENU_SETTINGS;
-    maxMenuItems = 8;
+    maxMenuItems = 9;
   }
   
   menuSelection = 0;
@@ -418,9 +448,12 @@ void cancelSetting() {
   if (currentMenu == MENU_FAILSAFE_THROTTLE_SETTING || currentMenu == MENU_FAILSAFE_STEERING_SETTING) {
     currentMenu = MENU_FAILSAFE_SETTINGS;
     maxMenuItems = 4;
+  } else if (currentMenu == MENU_MIN_RATE_SETTING || currentMenu == MENU_MAX_RATE_SETTING) {
+    currentMenu = MENU_LINK_SETTINGS;
+    maxMenuItems = 14;
   } else {
     currentMenu = MENU_SETTINGS;
-    maxMenuItems = 8;
+    maxMenuItems = 9;
   }
   
   menuSelection = 0;
@@ -479,6 +512,75 @@ void handleFailsafeSettingsSelection(int selection) {
   }
 }
 
+void handleLinkSettingsSelection(int selection) {
+  switch (selection) {
+    case 0: startSetting("MIN_RATE"); return;
+    case 1: startSetting("MAX_RATE"); return;
+    case 2: // Toggle frequency hopping
+      settings.hoppingEnabled = !settings.hoppingEnabled;
+      saveSettings();
+      Serial.print("Frequency hopping: ");
+      Serial.println(settings.hoppingEnabled ? "ON" : "OFF");
+      break;
+    case 3: // Cycle hop interval 1 -> 2 -> 4 -> 8 packets
+      settings.hopInterval = (settings.hopInterval >= 8) ? 1 : settings.hopInterval * 2;
+      saveSettings();
+      break;
+    case 4: // New random hop seed - receiver must be given the same seed
+      randomSeed(micros());
+      settings.hopSeed = random(1, 65536);
+      saveSettings();
+      Serial.print("New hop seed: 0x");
+      Serial.println(settings.hopSeed, HEX);
+      break;
+    case 5: // Cycle PA level - applied between two frames, no relink needed
+      settings.paLevel = (settings.paLevel + 1) % 4;
+      saveSettings();
+      break;
+    case 6: // Cycle data rate 1M -> 2M -> 250K - the receiver must follow (rebind)
+      settings.dataRate = (settings.dataRate + 1) % 3;
+      saveSettings();
+      Serial.println("Data rate changed - rebind the receiver");
+      break;
+    case 7: // Toggle link adaptation (needs RADIO_ACK_TELEMETRY to take effect)
+      settings.linkAdaptEnabled = !settings.linkAdaptEnabled;
+      saveSettings();
+      Serial.print("Link adaptation: ");
+      Serial.println(settings.linkAdaptEnabled ? "ON" : "OFF");
+      break;
+    case 8: // Cycle number of boats 1 -> TDMA_MAX_SLOTS - 1 means TDMA off
+      settings.tdmaSlots = (settings.tdmaSlots >= TDMA_MAX_SLOTS) ? 1 : settings.tdmaSlots + 1;
+      saveSettings();
+      Serial.print("TDMA slots: ");
+      Serial.println(settings.tdmaSlots);
+      break;
+    case 9: { // Cycle output RF -> PPM -> RF+PPM -> SBUS -> RF+SBUS -> CRSF -> RF+CRSF
+      uint8_t choice = (getOutputModeChoice() + 1) % OUTPUT_MODE_CHOICES;
+      settings.outputMode = outputModeChoices[choice];
+      saveSettings();
+      Serial.print("Output: ");
+      Serial.println(outputModeNames[choice]);
+      break;
+    }
+    case 10: // Round-trip latency test - the link keeps running
+      startPing();
+      currentMenu = MENU_PING;
+      break;
+    case 11: // Spectrum scanner - transmission pauses while it runs
+      beginRadioUse();
+      startScanner();
+      endRadioUse();
+      if (isScannerActive()) currentMenu = MENU_SPECTRUM_SCAN;
+      break;
+    case 12: // Bind receiver - transmission pauses while it runs
+      beginRadioUse();
+      startBind();
+      endRadioUse();
+      if (isBinding()) currentMenu = MENU_BIND;
+      break;
+  }
+}
+
 void resetAllSettings() {
   resetSettings();
   resetCalibration();
@@ -600,6 +702,26 @@ void drawSettingScreen() {
     display.println("Arrows: Adjust");
     display.setCursor(0, 52);
     display.print("Hold 1.5s: Rapid");
+    
+  } else if (currentMenu == MENU_MIN_RATE_SETTING || currentMenu == MENU_MAX_RATE_SETTING) {
+    bool isMin = (currentMenu == MENU_MIN_RATE_SETTING);
+    display.println(isMin ? "Min Packet Rate" : "Max Packet Rate");
+    display.setCursor(0, 16);
+    display.print("Rate: ");
+    display.print(isMin ? settings.minPacketRate : settings.maxPacketRate);
+    display.println(" Hz");
+    
+    // Draw bar - min covers 5-50 Hz, max covers 50-500 Hz
+    int barWidth = isMin ? map(settings.minPacketRate, 5, 50, 0, 100)
+                         : map(settings.maxPacketRate, 50, 500, 0, 100);
+    display.drawRect(10, 28, 102, 8, SSD1306_WHITE);
+    display.fillRect(11, 29, barWidth, 6, SSD1306_WHITE);
+    
+    // Instructions positioned to fit on screen (y=40 and y=52)
+    display.setCursor(0, 40);
+    display.println(isMin ? "Idle keep-alive" : "While sticks move");
+    display.setCursor(0, 52);
+    display.print("OK: Save");
   }
 }
 
@@ -0,0 +1,242 @@
+/*
+  ping.h - Over-the-air round-trip latency test
+  RC Transmitter for Arduino Mega
+
+  While the Ping Test screen is open every packed frame carries the
+  transmitter micros() value (RC_FLAG_TIMESTAMP, see rc_packet.h). The
+  receiver copies the newest timestamp into TelemetryData::echoTimestamp,
+  which comes back in the ACK payload.
+
+  The ACK payload is preloaded after a frame is received, so it rides on
+  the ACK of the following frame. The measured round trip is therefore the
+  real command-to-confirmation time at the current packet rate, and it
+  drops as the rate goes up. Needs RADIO_ACK_TELEMETRY and the packed
+  packet format.
+
+  The control link keeps running, so the test can be run armed at the
+  rates, channels and PA levels being accepted.
+
+  The histogram goes out on Serial as a console dump (serial_trainer.h),
+  one line per section, when the test is left or on Right, so printing it
+  never holds up the radio frames.
+*/
+
+#ifndef PING_H
+#define PING_H
+
+#include "config.h"
+#include "display.h"
+#include "radio.h"
+#include "menu_data.h"
+#include "serial_trainer.h"
+
+// Ping constants
+#define PING_BUCKETS 40
+#define PING_BUCKET_MICROS 500        // 0-20 ms in 0.5 ms steps, last bucket is overflow
+#define PING_MAX_AGE 1000000UL        // Echoes older than 1 s are stale, not a round trip
+#define PING_GRAPH_TOP 33
+#define PING_GRAPH_HEIGHT 22
+#define PING_DUMP_BUCKETS 3           // First histogram section of the dump
+
+// Round-trip statistics
+struct PingStats {
+  uint16_t buckets[PING_BUCKETS];
+  uint32_t count;
+  uint32_t sumMicros;
+  unsigned long minMicros;
+  unsigned long maxMicros;
+  uint32_t lastEcho;
+};
+
+PingStats pingStats;
+bool pingActive = false;
+bool pingLastOK = false;
+
+// External variables from menu.h
+extern MenuState currentMenu;
+extern int menuSelection;
+extern int menuOffset;
+extern int maxMenuItems;
+extern unsigned long lastNavigation;
+extern unsigned long menuTimer;
+
+// Forward declarations for external functions
+extern int getNavigationDirection();
+
+// Function declarations
+void startPing();
+void stopPing();
+void resetPing();
+void updatePing();
+void recordPingEcho(uint32_t echoTimestamp, unsigned long receivedAt);
+unsigned long getPingAverage();
+unsigned long getPingPercentile(uint8_t percent);
+void dumpPingHistogram();
+bool printPingSection(Print &out, uint16_t section);
+void drawPing();
+bool isPingActive();
+bool isPingSupported();
+
+void startPing() {
+  resetPing();
+  pingActive = true;
+  pingLastOK = buttons.btnOK; // Ignore the OK press that opened the screen
+  Serial.println("Ping test started");
+}
+
+void stopPing() {
+  if (!pingActive) return;
+  pingActive = false;
+  dumpPingHistogram();
+}
+
+void resetPing() {
+  memset(&pingStats, 0, sizeof(pingStats));
+  pingStats.minMicros = 0xFFFFFFFFUL;
+}
+
+void updatePing() {
+  if (!pingActive) return;
+  menuTimer = millis(); // Do not auto-exit the menu during a test
+
+  // OK - start a new measurement
+  bool currentOK = buttons.btnOK;
+  if (currentOK && !pingLastOK) resetPing();
+  pingLastOK = currentOK;
+
+  if (millis() - lastNavigation < NAV_DEBOUNCE) return;
+  int navDirection = getNavigationDirection();
+  if (navDirection == 2) { // Right - dump to Serial
+    dumpPingHistogram();
+    lastNavigation = millis();
+  } else if (navDirection == -2) { // Left - back to Link Settings
+    stopPing();
+    currentMenu = MENU_LINK_SETTINGS;
+    maxMenuItems = 14;
+    menuSelection = 0;
+    menuOffset = 0;
+    lastNavigation = millis();
+  }
+}
+
+void recordPingEcho(uint32_t echoTimestamp, unsigned long receivedAt) {
+  // The receiver repeats its last echo until a newer timestamp arrives
+  if (!pingActive || echoTimestamp == 0 || echoTimestamp == pingStats.lastEcho) return;
+  pingStats.lastEcho = echoTimestamp;
+
+  unsigned long rtt = receivedAt - echoTimestamp;
+  if (rtt > PING_MAX_AGE) return;
+
+  uint8_t bucket = min(rtt / PING_BUCKET_MICROS, (unsigned long)PING_BUCKETS - 1);
+  if (pingStats.buckets[bucket] < 0xFFFF) pingStats.buckets[bucket]++;
+  pingStats.count++;
+  pingStats.sumMicros += rtt;
+  if (rtt < pingStats.minMicros) pingStats.minMicros = rtt;
+  if (rtt > pingStats.maxMicros) pingStats.maxMicros = rtt;
+}
+
+unsigned long getPingAverage() {
+  return pingStats.count ? pingStats.sumMicros / pingStats.count : 0;
+}
+
+unsigned long getPingPercentile(uint8_t percent) {
+  // Upper edge of the bucket holding the percentile (exact max for the overflow bucket)
+  if (pingStats.count == 0) return 0;
+  uint32_t target = (pingStats.count * percent + 99) / 100;
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < PING_BUCKETS - 1; i++) {
+    seen += pingStats.buckets[i];
+    if (seen >= target) return min((unsigned long)(i + 1) * PING_BUCKET_MICROS, pingStats.maxMicros);
+  }
+  return pingStats.maxMicros;
+}
+
+void dumpPingHistogram() {
+  if (!startConsoleDump(printPingSection)) Serial.println("Console busy - try again");
+}
+
+bool printPingSection(Print &out, uint16_t section) {
+  // Console dump source - link settings, samples, summary, one bucket per section
+  if (section == 0) {
+    out.println("--- Ping RTT ---");
+    out.print("Rate: "); out.print(getCurrentPacketRate());
+    out.print(" Hz, channel "); out.print(getCurrentChannel());
+    out.print(", PA "); out.print(getTargetPALevel());
+    out.print(", data rate "); out.println(getTargetDataRate());
+  } else if (section == 1) {
+    out.print("Samples: "); out.println(pingStats.count);
+  } else if (pingStats.count == 0) {
+    return false;
+  } else if (section == 2) {
+    out.print("Min/Avg/P99/Max us: ");
+    out.print(pingStats.minMicros); out.print("/");
+    out.print(getPingAverage()); out.print("/");
+    out.print(getPingPercentile(99)); out.print("/");
+    out.println(pingStats.maxMicros);
+  } else if (section < PING_DUMP_BUCKETS + PING_BUCKETS) {
+    // Empty buckets leave their section empty
+    uint8_t i = section - PING_DUMP_BUCKETS;
+    if (pingStats.buckets[i] == 0) return true;
+    out.print(i * PING_BUCKET_MICROS / 1000.0, 1);
+    out.print(i == PING_BUCKETS - 1 ? "+ ms: " : " ms: ");
+    out.println(pingStats.buckets[i]);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool isPingActive() {
+  return pingActive;
+}
+
+bool isPingSupported() {
+  return RADIO_ACK_TELEMETRY && RADIO_PACKET_FORMAT == PACKET_FORMAT_PACKED;
+}
+
+void drawPing() {
+  display.setTextSize(1);
+  display.setCursor(0, 0);
+  display.print("Ping ");
+  display.print(getCurrentPacketRate());
+  display.print("Hz n:");
+  display.print(pingStats.count);
+
+  if (!isPingSupported()) {
+    display.setCursor(0, 20);
+    display.println("Needs packed format");
+    display.println("and ACK telemetry");
+    display.setCursor(0, 57);
+    display.print("<:Back");
+    return;
+  }
+
+  // Milliseconds with one decimal
+  display.setCursor(0, 8);
+  display.print("Min ");
+  display.print(pingStats.count ? pingStats.minMicros / 1000.0 : 0.0, 1);
+  display.print(" Avg ");
+  display.print(getPingAverage() / 1000.0, 1);
+  display.setCursor(0, 17);
+  display.print("P99 ");
+  display.print(getPingPercentile(99) / 1000.0, 1);
+  display.print(" Max ");
+  display.print(pingStats.maxMicros / 1000.0, 1);
+
+  // Histogram - 3 pixel columns per bucket
+  uint16_t maxCount = 1;
+  for (uint8_t i = 0; i < PING_BUCKETS; i++) {
+    if (pingStats.buckets[i] > maxCount) maxCount = pingStats.buckets[i];
+  }
+  for (uint8_t i = 0; i < PING_BUCKETS; i++) {
+    int height = (uint32_t)pingStats.buckets[i] * PING_GRAPH_HEIGHT / maxCount;
+    if (height > 0) {
+      display.fillRect(i * 3 + 4, PING_GRAPH_TOP + PING_GRAPH_HEIGHT - height, 2, height, SSD1306_WHITE);
+    }
+  }
+
+  display.setCursor(0, 57);
+  display.print("OK:Clr >:Dump <:Back");
+}
+
+#endif
@@ -0,0 +1,139 @@
+/*
+  ppm_output.h - PPM output on a hardware timer
+  RC Transmitter for Arduino Mega
+
+  Generates an 8-channel PPM stream on PPM_PIN (OC1A) for trainer ports
+  and external RF modules, from the same calibrated channel values the
+  radio sends (uiSnapshot, control_isr.h). Selected with the Output setting
+  (SettingsData::outputMode), alongside or instead of the nRF24.
+
+  Timer1 runs Fast PWM mode 14 (TOP = ICR1) at 0.5 us per tick, and every
+  timer period is one PPM slot: OC1A gives the PPM_PULSE separator at the
+  start of the period in hardware, and ICR1 sets the slot length (the
+  channel width, or the sync gap after the last channel). The overflow ISR
+  sets ICR1 for the period that has just started, which is at least
+  PPM_MIN_WIDTH long, so interrupt latency, display pushes and menu
+  activity never move an edge.
+
+  Channel widths are PPM_CENTER +/- 500 us for -1000..+1000. loop() hands
+  new values over through a pending buffer that the ISR takes at the start
+  of a frame, so a frame never mixes two updates.
+*/
+
+#ifndef PPM_OUTPUT_H
+#define PPM_OUTPUT_H
+
+#include "config.h"
+#include "control_isr.h"
+
+// PPM constants
+#define PPM_CHANNELS 8
+#define PPM_FRAME_MICROS 22500        // Full frame including the sync gap
+#define PPM_PULSE 300                 // Separator pulse (us)
+#define PPM_CENTER 1500
+#define PPM_MIN_WIDTH 900             // Clamp for channel widths (us)
+#define PPM_MAX_WIDTH 2100
+#define PPM_INVERTED 1                // 1 = idle high, low separator pulses (most modules)
+#define PPM_TICKS(us) ((uint16_t)((us) * 2UL)) // Timer1 at 16 MHz / 8
+
+// PPM state
+volatile uint16_t ppmWidths[PPM_CHANNELS];    // Ticks, used by the ISR
+volatile uint16_t ppmPending[PPM_CHANNELS];   // Ticks, written by loop()
+volatile bool ppmPendingReady = false;
+volatile uint8_t ppmSlot = 0;
+volatile uint32_t ppmFrames = 0;
+bool ppmRunning = false;
+
+// Forward declare settings getter
+extern uint8_t getOutputMode();
+
+// Function declarations
+void startPPM();
+void stopPPM();
+void updatePPM();
+uint16_t getPPMWidth(int16_t value);
+bool isPPMRunning();
+
+void startPPM() {
+  for (uint8_t i = 0; i < PPM_CHANNELS; i++) {
+    ppmWidths[i] = PPM_TICKS(PPM_CENTER);
+  }
+  ppmSlot = 0;
+
+  noInterrupts();
+  TCCR1A = 0;
+  TCCR1B = 0;
+  TCNT1 = 0;
+  ICR1 = PPM_TICKS(PPM_CENTER);
+  OCR1A = PPM_TICKS(PPM_PULSE);
+  // Fast PWM, TOP = ICR1 (mode 14); OC1A pulses at the start of each period
+  TCCR1A = _BV(WGM11) | (PPM_INVERTED ? _BV(COM1A1) | _BV(COM1A0) : _BV(COM1A1));
+  TCCR1B = _BV(WGM13) | _BV(WGM12) | _BV(CS11);
+  TIMSK1 = _BV(TOIE1);
+  interrupts();
+
+  pinMode(PPM_PIN, OUTPUT);
+  ppmRunning = true;
+  Serial.println("PPM output started");
+}
+
+void stopPPM() {
+  noInterrupts();
+  TIMSK1 = 0;
+  TCCR1A = 0;
+  TCCR1B = 0;
+  interrupts();
+
+  // Leave the line at its idle level
+  digitalWrite(PPM_PIN, PPM_INVERTED ? HIGH : LOW);
+  ppmRunning = false;
+  Serial.println("PPM output stopped");
+}
+
+ISR(TIMER1_OVF_vect) {
+  // A new period (slot) has just started at BOTTOM - set its length
+  uint8_t next = ppmSlot + 1;
+  if (next > PPM_CHANNELS) {
+    next = 0;
+    ppmFrames++;
+    if (ppmPendingReady) {
+      for (uint8_t i = 0; i < PPM_CHANNELS; i++) ppmWidths[i] = ppmPending[i];
+      ppmPendingReady = false;
+    }
+  }
+  ppmSlot = next;
+
+  if (next < PPM_CHANNELS) {
+    ICR1 = ppmWidths[next];
+  } else {
+    // Sync gap fills the frame up to PPM_FRAME_MICROS
+    uint16_t used = 0;
+    for (uint8_t i = 0; i < PPM_CHANNELS; i++) used += ppmWidths[i];
+    ICR1 = PPM_TICKS(PPM_FRAME_MICROS) - used;
+  }
+}
+
+void updatePPM() {
+  bool wanted = getOutputMode() & OUTPUT_PPM;
+  if (wanted && !ppmRunning) startPPM();
+  if (!wanted && ppmRunning) stopPPM();
+  if (!ppmRunning) return;
+
+  // Skip while the ISR still owes the previous update to a frame
+  if (ppmPendingReady) return;
+  for (uint8_t i = 0; i < PPM_CHANNELS; i++) {
+    ppmPending[i] = i < RC_CHANNEL_COUNT ? getPPMWidth(uiSnapshot.channels[i]) : PPM_TICKS(PPM_CENTER);
+  }
+  ppmPendingReady = true;
+}
+
+uint16_t getPPMWidth(int16_t value) {
+  long width = PPM_CENTER + (long)value / 2;
+  return PPM_TICKS(constrain(width, PPM_MIN_WIDTH, PPM_MAX_WIDTH));
+}
+
+bool isPPMRunning() {
+  return ppmRunning;
+}
+
+#endif
@@ -0,0 +1,159 @@
+/*
+  profiler.h - Per-subsystem loop profiler
+  RC Transmitter for Arduino Mega
+
+  Times the main sections of the transmitter with micros() and keeps, per
+  section, a log2 histogram of durations (bucket n holds 2^n..2^(n+1)-1 us,
+  the last bucket everything from 32 ms up), the run count, the worst
+  duration and the number of runs longer than PROF_FRAME_MICROS - the
+  20 ms receiver frame. PROF_LOOP times whole loop() passes, and the
+  loop frequency is counted per second.
+
+  Output:
+  - "#prof" on the serial console prints every section with its
+    histogram, "#prof reset" clears the counters. It is a console dump
+    (serial_trainer.h): each line goes out in PROF_DUMP_PARTS parts, the
+    counters and then half the histogram each, so no part outgrows the
+    console line buffer and loop() never waits on the UART.
+  - System Info shows the loop rate and each section's worst / overruns.
+
+  With PROFILER 0 in config.h the PROF_* macros expand to nothing and no
+  profiler state or code is built.
+*/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "config.h"
+
+// Profiled sections
+enum ProfSection {
+  PROF_LOOP,          // One loop() pass
+  PROF_BUTTONS,       // checkButtons()
+  PROF_JOYSTICKS,     // readJoysticks() / trainer input
+  PROF_TRANSMIT,      // transmitData()
+  PROF_MENU,          // updateMenu()
+  PROF_DISPLAY,       // updateDisplay() - drawing into the buffer
+  PROF_DISPLAY_PUSH,  // One display push chunk
+  PROF_SECTIONS
+};
+
+#if PROFILER
+
+#define PROF_BUCKETS 16
+#define PROF_FRAME_MICROS 20000       // A section this long misses a receiver frame
+#define PROF_INFO_ITEMS (PROF_SECTIONS + 1)
+#define PROF_DUMP_PARTS 3             // Dump sections per profiled section
+
+#define PROF_BEGIN(section) unsigned long profStart_##section = micros()
+#define PROF_END(section) recordProfile(section, micros() - profStart_##section)
+#define PROF_COUNT_LOOP() countProfileLoop()
+
+struct ProfileStats {
+  uint16_t histogram[PROF_BUCKETS];   // Saturating counts
+  uint32_t count;
+  uint16_t overruns;
+  unsigned long maxMicros;
+};
+
+const char* const profSectionNames[PROF_SECTIONS] = {
+  "Loop", "Buttons", "Sticks", "Transmit", "Menu", "Display", "Push"
+};
+
+ProfileStats profStats[PROF_SECTIONS];
+uint16_t profLoopRate = 0;            // loop() passes in the last second
+uint16_t profLoopCount = 0;
+unsigned long profRateStart = 0;
+
+// Function declarations
+void recordProfile(uint8_t section, unsigned long elapsed);
+void countProfileLoop();
+void resetProfile();
+bool printProfileSection(Print &out, uint16_t section);
+String getProfileText(uint8_t section);
+
+void recordProfile(uint8_t section, unsigned long elapsed) {
+  ProfileStats &s = profStats[section];
+  uint8_t bucket = 0;
+  for (unsigned long v = elapsed; v > 1 && bucket < PROF_BUCKETS - 1; v >>= 1) bucket++;
+  if (s.histogram[bucket] < 0xFFFF) s.histogram[bucket]++;
+  s.count++;
+  if (elapsed > s.maxMicros) s.maxMicros = elapsed;
+  if (elapsed > PROF_FRAME_MICROS && s.overruns < 0xFFFF) s.overruns++;
+}
+
+void countProfileLoop() {
+  profLoopCount++;
+  unsigned long now = millis();
+  if (now - profRateStart >= 1000) {
+    profLoopRate = profLoopCount;
+    profLoopCount = 0;
+    profRateStart = now;
+  }
+}
+
+void resetProfile() {
+  noInterrupts(); // The control ISR records too (control_isr.h)
+  memset(profStats, 0, sizeof(profStats));
+  interrupts();
+  Serial.println("Profiler reset");
+}
+
+bool printProfileSection(Print &out, uint16_t section) {
+  // Console dump source - header, then each profiled section in parts
+  if (section == 0) {
+    out.print("--- Profile --- loop ");
+    out.print(profLoopRate);
+    out.println(" Hz");
+    return true;
+  }
+  uint8_t i = (section - 1) / PROF_DUMP_PARTS;
+  uint8_t part = (section - 1) % PROF_DUMP_PARTS;
+  if (i >= PROF_SECTIONS) return false;
+
+  const ProfileStats &s = profStats[i];
+  if (part == 0) {
+    out.print(profSectionNames[i]);
+    out.print(": "); out.print(s.count);
+    out.print(" runs, max "); out.print(s.maxMicros);
+    out.print(" us, "); out.print(s.overruns);
+    out.print(" over "); out.print(PROF_FRAME_MICROS / 1000);
+    out.print(" ms |");
+    return true;
+  }
+
+  // Bucket label is its upper bound in us
+  uint8_t first = (part - 1) * (PROF_BUCKETS / 2);
+  for (uint8_t b = first; b < first + PROF_BUCKETS / 2; b++) {
+    if (s.histogram[b] == 0) continue;
+    out.print(b < PROF_BUCKETS - 1 ? " <" : " >=");
+    out.print(b < PROF_BUCKETS - 1 ? 2UL << b : 1UL << b);
+    out.print(":");
+    out.print(s.histogram[b]);
+  }
+  if (part == PROF_DUMP_PARTS - 1) out.println();
+  return true;
+}
+
+String getProfileText(uint8_t section) {
+  // One System Info line - worst duration and frame overruns
+  const ProfileStats &s = profStats[section];
+  String text = String(profSectionNames[section]) + " ";
+  if (s.maxMicros >= 10000) {
+    text += String(s.maxMicros / 1000) + "ms";
+  } else {
+    text += String(s.maxMicros) + "us";
+  }
+  return text + " ov" + String(s.overruns);
+}
+
+#else
+
+#define PROF_INFO_ITEMS 0
+#define PROF_BEGIN(section)
+#define PROF_END(section)
+#define PROF_COUNT_LOOP()
+
+#endif
+
+#endif
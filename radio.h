@@ -11,33 +11,152 @@
 #include <RF24.h>
 #include "config.h"
 #include "controls.h"
+#include "hopping.h"
+#include "tdma.h"
+#include "rc_packet.h"
+#include "link_stats.h"
+#include "redundancy.h"
+#include "subframes.h"
+#include "link_adapt.h"
+#include "frame_sync.h"
+#include "trace.h"
 
 // Radio object
 extern RF24 radio;
 extern bool radioOK;
 
+// Forward declare settings getters
+extern int getMinPacketRate();
+extern int getMaxPacketRate();
+extern bool isHoppingEnabled();
+extern uint16_t getHopSeed();
+extern int getHopInterval();
+extern uint8_t getRadioChannel();
+extern const char* getRadioAddress();
+extern uint8_t getRadioPALevel();
+extern uint8_t getRadioDataRate();
+extern uint8_t getTdmaSlots();
+extern uint8_t getTdmaMix(uint8_t slot);
+
+// Forward declare ping test hooks
+extern bool isPingActive();
+extern void recordPingEcho(uint32_t echoTimestamp, unsigned long receivedAt);
+
 // Function declarations
 void initRadio();
+void configureRadio();
+void setupRadioIRQ();
 void transmitData();
+void sendDataFrame();
+uint8_t sendNeutralBurst(uint8_t frames);
+bool isBurstAtRateSwitch();
 bool isRadioOK();
+void radioIRQHandler();
+void serviceRadioIRQ();
+uint8_t getCompletedFrames(uint8_t pending);
+void discardQueuedFrames();
+void readAckTelemetry(unsigned long receivedAt);
+bool isTelemetryFresh();
+void updatePacketRate();
+unsigned long getTransmitInterval();
+int getCurrentPacketRate();
+bool updateHopChannel(uint32_t counter);
+uint8_t getCurrentChannel();
+uint8_t buildTxPayload(uint8_t* buffer, uint8_t slot);
+bool isRadioConfigChanged();
+bool applyRadioConfig();
+void setRetriesForDataRate(uint8_t dataRate, uint8_t retries);
+uint8_t getTargetPALevel();
+uint8_t getTargetDataRate();
+uint8_t getTargetRetries();
+bool isTdmaEnabled();
+uint8_t nextTdmaSlot();
+bool selectTdmaSlot(uint8_t slot);
+void skipFrame(uint8_t slot);
+void queueFrame(const uint8_t* payload, uint8_t length, uint8_t redundant);
+uint16_t getFrameAirtime(uint8_t length);
 
 // Radio implementation
 RF24 radio(RADIO_CE, RADIO_CSN);
 bool radioOK = false;
 
+// Queued transmit state (RADIO_TX_QUEUED)
+// The ISR only raises a flag - all SPI traffic stays in loop() context
+volatile bool radioIrqPending = false;
+volatile unsigned long radioIrqTime = 0;
+bool lastTxResult = true;
+uint8_t txPending = 0;          // Frames queued but not yet reported by the IRQ
+uint32_t txFifoFullCount = 0;   // Frames skipped because the TX FIFO was still full
+
+// Outgoing frame - RCData or a packed rc_packet.h frame
+uint8_t txPayload[32];
+uint8_t txParity[32];           // Parity frame (RADIO_REDUNDANCY == REDUNDANCY_PARITY)
+
+// Receiver telemetry (RADIO_ACK_TELEMETRY)
+TelemetryData telemetry;
+unsigned long lastTelemetryTime = 0;
+uint32_t telemetryCount = 0;
+
+// Adaptive packet rate - max rate while the sticks move, decays to the
+// keep-alive rate once they have been still for RATE_HOLD_TIME
+int currentPacketRate = 1000 / TRANSMIT_INTERVAL;
+int rateRefThrottle = 0;
+int rateRefSteering = 0;
+unsigned long lastMotionTime = 0;
+unsigned long lastRateDecay = 0;
+
+// Frequency hopping - see hopping.h for the receiver timing contract
+uint8_t hopTable[HOP_TABLE_SIZE];
+uint16_t hopTableSeed = 0;
+bool hopTableValid = false;
+uint8_t currentChannel = RADIO_CHANNEL;
+uint32_t hopCount = 0;
+uint32_t hopDeferredCount = 0;   // Frames held back to let the FIFO drain before a hop
+
+// Time-slotted transmission - see tdma.h for the receiver slot contract
+uint8_t tdmaSlot = 0;                   // Slot served by the next tick
+uint8_t tdmaPipeSlot = 0;               // Slot whose address is loaded in TX_ADDR
+uint32_t tdmaCounter[TDMA_MAX_SLOTS];   // Per-receiver frame counters
+
+// Shadow of the settings the chip is programmed with, so a settings change
+// only rewrites the registers that differ. The channel is not kept here -
+// updateHopChannel() already compares it before every frame.
+struct RadioConfig {
+  char address[6];
+  uint8_t paLevel;
+  uint8_t dataRate;
+  uint8_t retries;
+};
+RadioConfig activeRadioConfig;
+
+// Reconfiguration timing
+unsigned long lastFrameQueuedAt = 0;
+unsigned long reconfigFrameBefore = 0;
+bool reconfigGapPending = false;
+unsigned long lastReconfigMicros = 0;    // SPI time spent rewriting registers
+unsigned long lastReconfigGap = 0;       // Frame-to-frame gap across the last reconfiguration (us)
+uint16_t reconfigCount = 0;
+
 void initRadio() {
   Serial.print("Initializing radio... ");
   
   radioOK = radio.begin();
   if (radioOK) {
-    radio.setDataRate(RF24_2MBPS);
-    radio.setPALevel(RF24_PA_HIGH);
-    radio.setChannel(RADIO_CHANNEL);
-    radio.setAutoAck(false);
-    radio.openWritingPipe((byte*)RADIO_ADDRESS);
-    radio.stopListening(); // Transmitter mode
+    configureRadio();
+    memset(&telemetry, 0, sizeof(telemetry));
+    resetLinkStats();
+    resetRedundancy();
+    resetSubframes();
+    
+#if RADIO_TX_QUEUED
+    setupRadioIRQ();
+    Serial.print("(queued TX) ");
+#endif
     
-    Serial.println("SUCCESS!");
+    Serial.print("SUCCESS! Address ");
+    Serial.print(getRadioAddress());
+    Serial.print(" Channel ");
+    Serial.println(getRadioChannel());
     // CRITICAL FIX: Use applyLEDSettings() instead of direct LED control
     extern void applyLEDSettings();
     applyLEDSettings();
@@ -50,16 +169,283 @@ void initRadio() {
   }
 }
 
+void configureRadio() {
+  // Full link setup from SettingsData - also used to return from bind mode,
+  // the radio test and a radio recovery, so adaptation starts over too
+  restartLinkAdapt();
+  radio.setDataRate((rf24_datarate_e)getTargetDataRate());
+  radio.setPALevel(getTargetPALevel());
+  currentChannel = getRadioChannel();
+  radio.setChannel(currentChannel);
+#if RADIO_ACK_TELEMETRY
+  // Receiver preloads its telemetry as the ACK payload of each RCData frame
+  radio.setAutoAck(true);
+  radio.enableDynamicPayloads();
+  radio.enableAckPayload();
+  setRetriesForDataRate(getTargetDataRate(), getTargetRetries());
+#else
+  radio.setAutoAck(false);
+  radio.disableAckPayload();
+  radio.disableDynamicPayloads();
+#endif
+#if RADIO_PACKET_FORMAT == PACKET_FORMAT_PACKED
+  // Packed frames are variable length - receiver must enable dynamic payloads too
+  radio.enableDynamicPayloads();
+#endif
+  radio.openWritingPipe((const uint8_t*)getRadioAddress());
+  radio.stopListening(); // Transmitter mode
+  tdmaPipeSlot = 0;
+  
+  strncpy(activeRadioConfig.address, getRadioAddress(), 5);
+  activeRadioConfig.address[5] = '\0';
+  activeRadioConfig.paLevel = getTargetPALevel();
+  activeRadioConfig.dataRate = getTargetDataRate();
+  activeRadioConfig.retries = getTargetRetries();
+}
+
+void setupRadioIRQ() {
+  // Also called after a re-initialisation - begin() unmasks every IRQ source
+#if RADIO_TX_QUEUED
+  // Only TX_DS / MAX_RT should pull the IRQ line low
+  radio.maskIRQ(false, false, true);
+  pinMode(RADIO_IRQ, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(RADIO_IRQ), radioIRQHandler, FALLING);
+#endif
+}
+
+void setRetriesForDataRate(uint8_t dataRate, uint8_t retries) {
+  // 500us retry delay keeps a lost ACK inside one frame.
+  // At 250 kbps an ACK payload needs 1500us before the chip may retry.
+  if (dataRate == RF24_250KBPS) {
+    radio.setRetries(5, retries);
+  } else {
+    radio.setRetries(1, retries);
+  }
+}
+
+// PA level, data rate and retries come from link_adapt.h while it runs,
+// otherwise from SettingsData
+uint8_t getTargetPALevel() {
+  return isLinkAdaptActive() ? getAdaptPALevel() : getRadioPALevel();
+}
+
+uint8_t getTargetDataRate() {
+  return isLinkAdaptActive() ? getAdaptDataRate() : getRadioDataRate();
+}
+
+uint8_t getTargetRetries() {
+  return isLinkAdaptActive() ? getAdaptRetries() : 3;
+}
+
+bool isRadioConfigChanged() {
+  return activeRadioConfig.paLevel != getTargetPALevel() ||
+         activeRadioConfig.dataRate != getTargetDataRate() ||
+         activeRadioConfig.retries != getTargetRetries() ||
+         strncmp(activeRadioConfig.address, getRadioAddress(), 5) != 0;
+}
+
+bool applyRadioConfig() {
+  // Called between two frames - registers must not change under a queued frame
+  TRACE_BEGIN(TRACE_RECONFIG);
+#if RADIO_TX_QUEUED && CONTROL_ISR
+  // No waiting inside the control ISR - skip this tick, the FIFO has
+  // drained by a later one
+  if (!radio.isFifo(true, true)) {
+    TRACE_END(TRACE_RECONFIG);
+    return false;
+  }
+  serviceRadioIRQ();
+#elif RADIO_TX_QUEUED
+  unsigned long drainStart = micros();
+  while (!radio.isFifo(true, true)) {
+    if (micros() - drainStart > RADIO_RECONFIG_DRAIN) {
+      TRACE_END(TRACE_RECONFIG);
+      return false;
+    }
+  }
+  serviceRadioIRQ(); // Credit the frames that just drained
+#endif
+  
+  unsigned long start = micros();
+  if (activeRadioConfig.dataRate != getTargetDataRate() ||
+      activeRadioConfig.retries != getTargetRetries()) {
+    if (activeRadioConfig.dataRate != getTargetDataRate()) {
+      activeRadioConfig.dataRate = getTargetDataRate();
+      radio.setDataRate((rf24_datarate_e)activeRadioConfig.dataRate);
+    }
+    activeRadioConfig.retries = getTargetRetries();
+#if RADIO_ACK_TELEMETRY
+    setRetriesForDataRate(activeRadioConfig.dataRate, activeRadioConfig.retries);
+#endif
+  }
+  if (activeRadioConfig.paLevel != getTargetPALevel()) {
+    activeRadioConfig.paLevel = getTargetPALevel();
+    radio.setPALevel(activeRadioConfig.paLevel);
+  }
+  if (strncmp(activeRadioConfig.address, getRadioAddress(), 5) != 0) {
+    strncpy(activeRadioConfig.address, getRadioAddress(), 5);
+    radio.openWritingPipe((const uint8_t*)activeRadioConfig.address);
+    tdmaPipeSlot = 0;
+  }
+  lastReconfigMicros = micros() - start;
+  reconfigCount++;
+  
+  // The gap is measured when the next frame goes out
+  reconfigFrameBefore = lastFrameQueuedAt;
+  reconfigGapPending = true;
+  TRACE_END(TRACE_RECONFIG);
+  return true;
+}
+
+uint8_t getCompletedFrames(uint8_t pending) {
+  // One IRQ can cover several frames - all of them are done once the FIFO is
+  // empty. Whatever is left is still in flight or, after MAX_RT, the failed
+  // frame and those queued behind it. The FIFO only reports empty and full.
+  if (radio.isFifo(true, true)) return pending;
+  uint8_t left = radio.isFifo(true, false) ? 3 : 1;
+  return pending > left ? pending - left : 0;
+}
+
+void discardQueuedFrames() {
+  // For a menu tool taking over the chip: queued link frames never went out,
+  // so they count as skipped, and their TX_DS / MAX_RT flags are cleared so
+  // they are not credited to the next frames after the tool is done
+  radio.flush_tx();
+  while (txPending > 0) {
+    recordTxSkipped();
+    txPending--;
+  }
+  bool txOk, txFail, rxReady;
+  radio.whatHappened(txOk, txFail, rxReady);
+  radioIrqPending = false;
+}
+
+void radioIRQHandler() {
+  radioIrqTime = micros(); // Completion time for the link stats gap figures
+  radioIrqPending = true;
+}
+
+void serviceRadioIRQ() {
+  // The IRQ line stays LOW until the status flags are cleared, so also treat
+  // a LOW level as pending in case an edge was missed
+  if (!radioIrqPending && digitalRead(RADIO_IRQ) == HIGH) return;
+  unsigned long completedAt = radioIrqPending ? radioIrqTime : micros();
+  radioIrqPending = false;
+  
+  bool txOk, txFail, rxReady;
+  radio.whatHappened(txOk, txFail, rxReady); // Reads and clears the flags in one SPI transfer
+  uint8_t retries = radio.getARC();
+  
+  if (txOk) {
+    lastTxResult = true;
+    uint8_t done = getCompletedFrames(txPending);
+    for (uint8_t i = 0; i < done && txPending > 0; i++) {
+      recordTxResult(true, retries, completedAt);
+      txPending--;
+    }
+#if RADIO_ACK_TELEMETRY
+    readAckTelemetry(completedAt);
+#endif
+  }
+  if (txFail) {
+    // MAX_RT leaves the failed payload at the head of the FIFO - drop it
+    // together with anything queued behind it
+    lastTxResult = false;
+    radio.flush_tx();
+    while (txPending > 0) {
+      recordTxResult(false, retries, completedAt);
+      txPending--;
+    }
+  }
+}
+
 void transmitData() {
+  TRACE_BEGIN(TRACE_TRANSMIT);
+  sendDataFrame();
+  TRACE_END(TRACE_TRANSMIT);
+}
+
+void sendDataFrame() {
+  // The slot advances on every tick, sent or not, so slot timing stays fixed
+  uint8_t slot = nextTdmaSlot();
+  
+  // The health monitor owns the chip until it is re-initialised
+  if (!radioOK) {
+    skipFrame(slot);
+    return;
+  }
+  
+#if RADIO_TX_QUEUED
+  // Collect completions from earlier frames, then queue this one without
+  // waiting for it to go out. If the FIFO is still full the radio is behind,
+  // so skip this frame rather than stall loop().
+  serviceRadioIRQ();
+  updateLinkStats();
+  if (radio.isFifo(true, false)) {
+    txFifoFullCount++;
+    skipFrame(slot);
+    return;
+  }
+  updateLinkAdapt();
+  checkAdaptSwitch(data.counter + 1);
+  if (isRadioConfigChanged() && !applyRadioConfig()) {
+    skipFrame(slot);
+    return;
+  }
+  if (!selectTdmaSlot(slot) || !updateHopChannel(data.counter + 1)) {
+    skipFrame(slot);
+    return;
+  }
+  data.counter++;
+  tdmaCounter[slot]++;
+  uint8_t length = buildTxPayload(txPayload, slot);
+  if (!testDropFrame(slot)) queueFrame(txPayload, length, getRedundantBytes(length));
+  
+  // A parity frame follows the last frame of its group on the same channel
+  uint8_t parityLength = takeParityPacket(txParity, slot);
+  if (parityLength > 0 && !testDropParity(slot, !radio.isFifo(true, false))) {
+    queueFrame(txParity, parityLength, parityLength);
+  }
+  bool result = lastTxResult;
+#else
+  updateLinkAdapt();
+  checkAdaptSwitch(data.counter + 1);
+  if (isRadioConfigChanged()) applyRadioConfig();
+  selectTdmaSlot(slot);
+  updateHopChannel(data.counter + 1); // Blocking write leaves the FIFO empty
   data.counter++;
-  bool result = radio.write(&data, sizeof(data));
+  tdmaCounter[slot]++;
+  uint8_t length = buildTxPayload(txPayload, slot);
+  bool result = true;
+  if (!testDropFrame(slot)) {
+    result = radio.write(txPayload, length);
+    recordTxResult(result, radio.getARC(), micros());
+    recordTxAirtime(length, getRedundantBytes(length), getFrameAirtime(length));
+  }
+  uint8_t parityLength = takeParityPacket(txParity, slot);
+  if (parityLength > 0 && !testDropParity(slot, true)) {
+    radio.write(txParity, parityLength);
+    recordTxAirtime(parityLength, parityLength, getFrameAirtime(parityLength));
+  }
+  updateLinkStats();
+#if RADIO_ACK_TELEMETRY
+  if (result) readAckTelemetry(micros());
+#endif
+#endif
+  
+  lastFrameQueuedAt = micros();
+  recordSlotSent(slot, lastFrameQueuedAt);
+  if (reconfigGapPending) {
+    reconfigGapPending = false;
+    if (reconfigFrameBefore != 0) lastReconfigGap = lastFrameQueuedAt - reconfigFrameBefore;
+  }
   
   // CRITICAL FIX: Remove all LED feedback from radio transmission
   // The LED state should be controlled entirely by the menu system
   // based on armed/disarmed/menu state, not transmission status
   
-  // Debug output every DEBUG_INTERVAL packets
-  if (data.counter % DEBUG_INTERVAL == 0) {
+  // Debug output every DEBUG_INTERVAL packets - not from the control ISR
+  if (!CONTROL_ISR && data.counter % DEBUG_INTERVAL == 0) {
     Serial.print("TX - T:");
     Serial.print(data.throttle);
     Serial.print(" S:");
@@ -73,7 +459,239 @@ void transmitData() {
     if (!result) {
       Serial.println("Warning: Transmission failed");
     }
+#if RADIO_TX_QUEUED
+    if (txFifoFullCount > 0) {
+      Serial.print("TX FIFO full, frames skipped: ");
+      Serial.println(txFifoFullCount);
+    }
+#endif
+  }
+}
+
+uint8_t sendNeutralBurst(uint8_t frames) {
+  // Disarm burst - channels are already neutral. Runs from the fast disarm
+  // ISR (queued TX only) or from loop() between radio sections, never while
+  // loop() is inside one. Returns the length of the first frame, 0 if none.
+  if (!radioOK) return 0;
+  TRACE_MARK(TRACE_DISARM);
+  uint8_t slot = tdmaPipeSlot; // Other TDMA slots get neutral frames on their next tick
+  uint8_t firstLength = 0;
+  
+#if RADIO_TX_QUEUED
+  // Armed frames still queued must not go out after the disarm
+  radio.flush_tx();
+  while (txPending > 0) {
+    recordTxSkipped();
+    txPending--;
   }
+  updateHopChannel(data.counter + 1); // FIFO is empty, so this always retunes
+  for (uint8_t i = 0; i < frames && !radio.isFifo(true, false) && !isBurstAtRateSwitch(); i++) {
+    data.counter++;
+    tdmaCounter[slot]++;
+    uint8_t length = buildTxPayload(txPayload, slot);
+    queueFrame(txPayload, length, getRedundantBytes(length));
+    if (i == 0) firstLength = length;
+    // Keep parity groups aligned - a parity frame without room is dropped
+    uint8_t parityLength = takeParityPacket(txParity, slot);
+    if (parityLength > 0 && !radio.isFifo(true, false)) {
+      queueFrame(txParity, parityLength, parityLength);
+    }
+  }
+#else
+  for (uint8_t i = 0; i < frames && !isBurstAtRateSwitch(); i++) {
+    updateHopChannel(data.counter + 1);
+    data.counter++;
+    tdmaCounter[slot]++;
+    uint8_t length = buildTxPayload(txPayload, slot);
+    if (i == 0) firstLength = length;
+    recordTxResult(radio.write(txPayload, length), radio.getARC(), micros());
+    recordTxAirtime(length, getRedundantBytes(length), getFrameAirtime(length));
+    uint8_t parityLength = takeParityPacket(txParity, slot);
+    if (parityLength > 0) {
+      radio.write(txParity, parityLength);
+      recordTxAirtime(parityLength, parityLength, getFrameAirtime(parityLength));
+    }
+  }
+#endif
+  lastFrameQueuedAt = micros();
+  return firstLength;
+}
+
+bool isBurstAtRateSwitch() {
+  // The announced first frame at a new data rate is left to transmitData()
+  return isAdaptAnnouncing() && (int32_t)(data.counter + 1 - adaptSwitchCounter) >= 0;
+}
+
+uint8_t buildTxPayload(uint8_t* buffer, uint8_t slot) {
+  const int16_t* source = channels;
+  uint32_t counter = data.counter;
+  int16_t mixed[RC_CHANNEL_COUNT];
+  
+  if (isTdmaEnabled()) {
+    // Each receiver gets its own mix and counts its own frames
+    mixSlotChannels(getTdmaMix(slot), channels, mixed);
+    source = mixed;
+    counter = tdmaCounter[slot];
+  }
+  
+#if RADIO_PACKET_FORMAT == PACKET_FORMAT_PACKED
+  // Sequence is the low byte of the counter, so hop timing is unchanged
+  uint8_t length = encodeScheduledPacket(buffer, (uint8_t)counter, slot, source);
+  if (isAdaptAnnouncing()) {
+    length = appendRCLinkConfig(buffer, length, adaptLadder[adaptStep].dataRate, (uint8_t)adaptSwitchCounter);
+  }
+  // Timestamp as late as possible so the round trip excludes encoding,
+  // left out when a delta frame with an announcement has no room for it
+  if (isPingActive() && length + RC_TIMESTAMP_SIZE <= 32) {
+    length = appendRCTimestamp(buffer, length, micros());
+  }
+  return length;
+#else
+  RCData frame;
+  frame.throttle = source[CH_THROTTLE];
+  frame.steering = source[CH_STEERING];
+  frame.counter = counter;
+  memcpy(buffer, &frame, sizeof(frame));
+  return sizeof(frame);
+#endif
+}
+
+bool isTdmaEnabled() {
+  return getTdmaSlots() > 1;
+}
+
+uint8_t nextTdmaSlot() {
+  uint8_t slots = getTdmaSlots();
+  uint8_t slot = tdmaSlot < slots ? tdmaSlot : 0;
+  tdmaSlot = (slot + 1) % slots;
+  return slot;
+}
+
+bool selectTdmaSlot(uint8_t slot) {
+  if (slot == tdmaPipeSlot) return true;
+  
+#if RADIO_TX_QUEUED
+  // TX_ADDR is used when a frame goes out - never switch under a queued frame
+  if (!radio.isFifo(true, true)) return false;
+#endif
+  
+  char address[6];
+  makeSlotAddress(getRadioAddress(), slot, address);
+  radio.openWritingPipe((const uint8_t*)address);
+  tdmaPipeSlot = slot;
+  return true;
+}
+
+void skipFrame(uint8_t slot) {
+  recordTxSkipped();
+  recordSlotSkipped(slot);
+}
+
+void queueFrame(const uint8_t* payload, uint8_t length, uint8_t redundant) {
+  radio.startFastWrite(payload, length, false);
+  txPending++;
+  recordTxAirtime(length, redundant, getFrameAirtime(length));
+}
+
+uint16_t getFrameAirtime(uint8_t length) {
+  // Preamble, 5-byte address, 9-bit packet control field, payload and 2-byte CRC
+  uint16_t bits = (1 + 5 + length + 2) * 8 + 9;
+  switch (activeRadioConfig.dataRate) {
+    case RF24_2MBPS: return bits / 2;
+    case RF24_250KBPS: return bits * 4;
+    default: return bits;
+  }
+}
+
+void readAckTelemetry(unsigned long receivedAt) {
+  while (radio.available()) {
+    uint8_t len = radio.getDynamicPayloadSize(); // Returns 0 (and flushes) on a corrupt length
+    if (len == 0) break;
+    
+    uint8_t buffer[32];
+    radio.read(buffer, len);
+    
+    // Accept shorter payloads from older receivers, ignore any extra bytes
+    memset(&telemetry, 0, sizeof(telemetry));
+    memcpy(&telemetry, buffer, min((int)len, (int)sizeof(telemetry)));
+    lastTelemetryTime = millis();
+    telemetryCount++;
+    recordPingEcho(telemetry.echoTimestamp, receivedAt);
+    recordFramePhase(telemetry.outputPeriod, telemetry.outputLead, telemetry.phaseSequence);
+  }
+}
+
+bool isTelemetryFresh() {
+  return telemetryCount > 0 && millis() - lastTelemetryTime < TELEMETRY_TIMEOUT;
+}
+
+void updatePacketRate() {
+  int minRate = getMinPacketRate();
+  int maxRate = getMaxPacketRate();
+  
+  // Compare against the values at the last motion event rather than the last
+  // frame, so slow sweeps are detected the same way at any packet rate
+  if (abs(data.throttle - rateRefThrottle) >= RATE_MOTION_THRESHOLD ||
+      abs(data.steering - rateRefSteering) >= RATE_MOTION_THRESHOLD) {
+    rateRefThrottle = data.throttle;
+    rateRefSteering = data.steering;
+    lastMotionTime = millis();
+    currentPacketRate = maxRate;
+  } else if (millis() - lastMotionTime > RATE_HOLD_TIME &&
+             millis() - lastRateDecay >= RATE_DECAY_STEP) {
+    // Ease down by 1/8 per step instead of dropping straight to keep-alive
+    currentPacketRate -= currentPacketRate / 8 + 1;
+    lastRateDecay = millis();
+  }
+  
+  currentPacketRate = constrain(currentPacketRate, minRate, maxRate);
+}
+
+unsigned long getTransmitInterval() {
+  // Microseconds - millis() is too coarse above 250 Hz
+  if (!isTdmaEnabled()) return 1000000UL / currentPacketRate;
+  
+  // The packet rate is per receiver, so the slots share the tick rate
+  unsigned long interval = 1000000UL / ((unsigned long)currentPacketRate * getTdmaSlots());
+  return max(interval, (unsigned long)TDMA_MIN_SLOT_MICROS);
+}
+
+int getCurrentPacketRate() {
+  return currentPacketRate;
+}
+
+bool updateHopChannel(uint32_t counter) {
+  uint8_t channel = getRadioChannel();
+  
+  // TDMA slots share one channel - the hop sequence follows a single counter
+  if (isHoppingEnabled() && !isTdmaEnabled()) {
+    // Rebuild the table whenever the seed changes (menu or bind)
+    if (!hopTableValid || hopTableSeed != getHopSeed()) {
+      hopTableSeed = getHopSeed();
+      generateHopTable(hopTableSeed, hopTable);
+      hopTableValid = true;
+    }
+    channel = getHopChannel(hopTable, counter, getHopInterval());
+  }
+  
+  if (channel == currentChannel) return true;
+  
+#if RADIO_TX_QUEUED
+  // Never retune with frames still queued - they would go out on the new channel
+  if (!radio.isFifo(true, true)) {
+    hopDeferredCount++;
+    return false;
+  }
+#endif
+  
+  radio.setChannel(channel);
+  currentChannel = channel;
+  hopCount++;
+  return true;
+}
+
+uint8_t getCurrentChannel() {
+  return currentChannel;
 }
 
 bool isRadioOK() {
@@ -0,0 +1,139 @@
+/*
+  radio_health.h - Runtime radio health monitor
+  RC Transmitter for Arduino Mega
+
+  radioOK used to be set once at boot. This monitor keeps checking the
+  chip while the link runs and re-initialises it when it stops answering,
+  so a brown-out or an SPI glitch does not need a power cycle.
+
+  Checks, all from loop() context:
+  - Every HEALTH_CHECK_INTERVAL: isChipConnected() plus a read-back of
+    the channel, data rate, PA level and CRC length. A reset chip comes
+    back at its power-on defaults (8-bit CRC), so a brown-out shows up
+    here even when SPI still answers.
+  - HEALTH_FAIL_STREAK frames lost in a row only shortens the interval to
+    HEALTH_FAIL_CHECK_INTERVAL - a receiver that is off looks the same.
+  - HEALTH_SKIP_STREAK ticks skipped in a row with no completion at all
+    means the TX FIFO is stuck, which is a fault on its own.
+
+  Recovery bound: the first attempt runs in the same pass as the failed
+  check, further attempts every HEALTH_RETRY_INTERVAL. One attempt is a
+  radio.begin() plus configureRadio() (about 10 ms, most of it the chip
+  power-up delay), so loop() and the UI never stall longer than that.
+  Frames are skipped while the chip is down and the receiver failsafe
+  takes over. Faults, recoveries and downtime go to link_stats.h.
+*/
+
+#ifndef RADIO_HEALTH_H
+#define RADIO_HEALTH_H
+
+#include "config.h"
+#include "radio.h"
+#include "link_stats.h"
+
+// Health monitor constants
+#define HEALTH_CHECK_INTERVAL 200       // ms between chip checks
+#define HEALTH_FAIL_CHECK_INTERVAL 20   // ms between checks while frames keep failing
+#define HEALTH_FAIL_STREAK 25           // Lost frames in a row before checking faster
+#define HEALTH_SKIP_STREAK 50           // Skipped ticks in a row that count as a stuck chip
+#define HEALTH_RETRY_INTERVAL 100       // ms between re-initialisation attempts
+
+// Health monitor state
+unsigned long lastHealthCheck = 0;
+unsigned long lastRecoveryAttempt = 0;
+unsigned long radioFaultStart = 0;
+unsigned long lastRecoveryAttemptMicros = 0;   // Duration of the last attempt
+uint16_t recoveryAttempts = 0;
+const char* radioFaultReason = "";
+
+// Forward declare link pause check (menu.h)
+extern bool isLinkPaused();
+
+// Function declarations
+void updateRadioHealth();
+bool checkRadioChip();
+void handleRadioFault(const char* reason);
+bool attemptRadioRecovery();
+
+void updateRadioHealth() {
+  // The scanner and bind mode reprogram the chip on purpose
+  if (isLinkPaused()) return;
+  unsigned long now = millis();
+
+  if (!radioOK) {
+    if (now - lastRecoveryAttempt >= HEALTH_RETRY_INTERVAL) attemptRadioRecovery();
+    return;
+  }
+
+  if (linkStats.skipStreak >= HEALTH_SKIP_STREAK) {
+    handleRadioFault("TX FIFO stuck");
+    return;
+  }
+
+  unsigned long interval = linkStats.failStreak >= HEALTH_FAIL_STREAK ?
+                           HEALTH_FAIL_CHECK_INTERVAL : HEALTH_CHECK_INTERVAL;
+  if (now - lastHealthCheck < interval) return;
+  lastHealthCheck = now;
+
+  if (!checkRadioChip()) handleRadioFault(radioFaultReason);
+}
+
+bool checkRadioChip() {
+  if (!radio.isChipConnected()) {
+    radioFaultReason = "no SPI response";
+    return false;
+  }
+  if (radio.getChannel() != getCurrentChannel() ||
+      radio.getDataRate() != activeRadioConfig.dataRate ||
+      radio.getPALevel() != activeRadioConfig.paLevel ||
+      radio.getCRCLength() != RF24_CRC_16) {
+    radioFaultReason = "registers lost";
+    return false;
+  }
+  return true;
+}
+
+void handleRadioFault(const char* reason) {
+  radioOK = false;
+  radioFaultStart = millis();
+  recordRadioFault();
+  Serial.print("Radio fault: ");
+  Serial.println(reason);
+
+  // Whatever was queued went down with the chip
+  while (txPending > 0) {
+    recordTxResult(false, 0, micros());
+    txPending--;
+  }
+  radioIrqPending = false;
+
+  attemptRadioRecovery();
+}
+
+bool attemptRadioRecovery() {
+  unsigned long start = micros();
+  lastRecoveryAttempt = millis();
+  recoveryAttempts++;
+
+  bool ok = radio.begin();
+  if (ok) {
+    configureRadio();
+    setupRadioIRQ();
+    radio.flush_tx();
+    ok = checkRadioChip();
+  }
+  lastRecoveryAttemptMicros = micros() - start;
+  if (!ok) return false;
+
+  radioOK = true;
+  lastHealthCheck = millis();
+  recordRadioRecovered(millis() - radioFaultStart);
+  Serial.print("Radio recovered after ");
+  Serial.print(linkStats.lastRecoveryTime);
+  Serial.print(" ms (attempt ");
+  Serial.print(lastRecoveryAttemptMicros);
+  Serial.println(" us)");
+  return true;
+}
+
+#endif
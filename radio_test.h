@@ -0,0 +1,330 @@
+/*
+  radio_test.h - Radio throughput / packet error rate benchmark
+  RC Transmitter for Arduino Mega
+
+  Main menu > Radio Test. Sweeps every data rate against RTEST_SIZES
+  payload sizes and bursts frames for RTEST_STEP_TIME at each step,
+  keeping the TX FIFO full so the chip sends back to back. Each step
+  reports achieved frames/s, write failures (MAX_RT or a frame that never
+  completed) and, with RADIO_ACK_TELEMETRY, the packet error rate and
+  retries per frame. Results go to the OLED and to Serial, so a field
+  session starts from a reproducible number.
+
+  The control link is paused while the test runs, so it can only be
+  started while DISARMED and arming aborts it. Frames go to the bound
+  address on the current channel and start with a neutral RCData frame
+  (zero padded), so a legacy receiver that decodes one sees centred
+  controls and a packed receiver rejects it on version / CRC. With auto-ack
+  the PER is only meaningful at the data rate the receiver listens on -
+  the other rates show as loss.
+
+  Bursts run in RTEST_SLICE_MICROS slices per loop() pass so the menu and
+  display stay live; frames/s is taken over the time spent bursting.
+*/
+
+#ifndef RADIO_TEST_H
+#define RADIO_TEST_H
+
+#include "config.h"
+#include "display.h"
+#include "radio.h"
+#include "menu_data.h"
+
+// Radio test constants
+#define RTEST_RATES 3
+#define RTEST_SIZES 3
+#define RTEST_STEPS (RTEST_RATES * RTEST_SIZES)
+#define RTEST_STEP_TIME 1000          // ms of bursting per step
+#define RTEST_SLICE_MICROS 20000      // Longest burst per updateRadioTest() call
+#define RTEST_FRAME_TIMEOUT 10000     // us without a completion before queued frames count as failed
+
+const uint8_t rtestRates[RTEST_RATES] = {RF24_2MBPS, RF24_1MBPS, RF24_250KBPS};
+const uint8_t rtestSizes[RTEST_SIZES] = {8, 16, 32};
+
+// Result of one data rate / payload size step
+struct RadioTestResult {
+  uint32_t delivered;
+  uint32_t failed;          // MAX_RT or timed out
+  uint32_t retries;
+  unsigned long activeMicros;
+};
+
+RadioTestResult rtestResults[RTEST_STEPS];
+bool rtestRunning = false;
+bool rtestDone = false;
+uint8_t rtestStep = 0;
+uint8_t rtestPage = 0;             // Data rate shown on the results screen
+uint8_t rtestPending = 0;          // Frames in the TX FIFO
+unsigned long rtestStepStart = 0;
+unsigned long rtestLastProgress = 0;
+bool rtestLastOK = false;
+uint8_t rtestPayload[32];
+
+// External variables from menu.h
+extern MenuState currentMenu;
+extern int menuSelection;
+extern int menuOffset;
+extern int maxMenuItems;
+extern unsigned long lastNavigation;
+extern unsigned long menuTimer;
+
+// Forward declarations for external functions
+extern int getNavigationDirection();
+extern const char* const dataRateNames[];
+
+// Function declarations
+void startRadioTest();
+void stopRadioTest();
+void updateRadioTest();
+void startRadioTestStep();
+void runRadioTestSlice();
+void collectRadioTest(RadioTestResult &r);
+void finishRadioTestStep();
+void endRadioTest();
+uint16_t getRadioTestRate(const RadioTestResult &r);
+uint16_t getRadioTestPERx10(const RadioTestResult &r);
+void printRadioTestResult(uint8_t step);
+void drawRadioTest();
+bool isRadioTestActive();
+bool isRadioTestRunning();
+
+void startRadioTest() {
+  if (getArmedStatus()) {
+    Serial.println("Radio test blocked - disarm first");
+    return;
+  }
+
+  Serial.println("--- Radio Test ---");
+  Serial.print("Channel "); Serial.print(getCurrentChannel());
+  Serial.print(", PA "); Serial.print(getTargetPALevel());
+  Serial.println(RADIO_ACK_TELEMETRY ? ", auto-ack" : ", no ack");
+
+  memset(rtestResults, 0, sizeof(rtestResults));
+  rtestStep = 0;
+  rtestPage = 0;
+  rtestDone = false;
+  rtestLastOK = buttons.btnOK; // Ignore the OK press that started the test
+  rtestRunning = true;
+
+  // Neutral RCData at the start of every payload, zero padded
+  RCData neutral;
+  neutral.throttle = 0;
+  neutral.steering = 0;
+  neutral.counter = 0;
+  memset(rtestPayload, 0, sizeof(rtestPayload));
+  memcpy(rtestPayload, &neutral, sizeof(neutral));
+
+  // Sizes only differ on air with dynamic payloads
+  discardQueuedFrames();
+  radio.enableDynamicPayloads();
+  startRadioTestStep();
+}
+
+void stopRadioTest() {
+  if (!rtestRunning) return;
+  Serial.println("Radio test aborted");
+  endRadioTest();
+}
+
+void updateRadioTest() {
+  if (currentMenu != MENU_RADIO_TEST) return;
+  menuTimer = millis(); // Do not auto-exit the menu during a test
+
+  if (rtestRunning) {
+    // The control link has priority - arming aborts the test
+    if (getArmedStatus()) {
+      stopRadioTest();
+    } else {
+      runRadioTestSlice();
+      if (millis() - rtestStepStart >= RTEST_STEP_TIME) {
+        finishRadioTestStep();
+        printRadioTestResult(rtestStep);
+        if (++rtestStep < RTEST_STEPS) {
+          startRadioTestStep();
+        } else {
+          rtestDone = true;
+          endRadioTest();
+          Serial.println("Radio test complete");
+        }
+      }
+    }
+  }
+
+  // OK - run the sweep again
+  bool currentOK = buttons.btnOK;
+  if (currentOK && !rtestLastOK && !rtestRunning) startRadioTest();
+  rtestLastOK = currentOK;
+
+  if (millis() - lastNavigation < NAV_DEBOUNCE) return;
+  int navDirection = getNavigationDirection();
+  if (navDirection == 2) { // Right - next data rate page
+    rtestPage = (rtestPage + 1) % RTEST_RATES;
+    lastNavigation = millis();
+  } else if (navDirection == -2) { // Left - back to the main menu
+    stopRadioTest();
+    currentMenu = MENU_MAIN;
+    maxMenuItems = 7;
+    menuSelection = 0;
+    menuOffset = 0;
+    lastNavigation = millis();
+  }
+}
+
+void startRadioTestStep() {
+  uint8_t dataRate = rtestRates[rtestStep / RTEST_SIZES];
+  radio.setDataRate((rf24_datarate_e)dataRate);
+#if RADIO_ACK_TELEMETRY
+  setRetriesForDataRate(dataRate, getTargetRetries());
+#endif
+  rtestPage = rtestStep / RTEST_SIZES;
+  rtestPending = 0;
+  rtestStepStart = millis();
+  rtestLastProgress = micros();
+}
+
+void runRadioTestSlice() {
+  RadioTestResult &r = rtestResults[rtestStep];
+  uint8_t size = rtestSizes[rtestStep % RTEST_SIZES];
+  unsigned long sliceStart = micros();
+
+  // Keep the FIFO full for the slice, then let it drain so nothing is in
+  // flight while loop() runs the UI
+  while (micros() - sliceStart < RTEST_SLICE_MICROS || rtestPending > 0) {
+    collectRadioTest(r);
+
+    if (rtestPending > 0 && micros() - rtestLastProgress > RTEST_FRAME_TIMEOUT) {
+      r.failed += rtestPending;
+      rtestPending = 0;
+      radio.flush_tx();
+    }
+
+    if (micros() - sliceStart < RTEST_SLICE_MICROS && !radio.isFifo(true, false)) {
+      if (rtestPending == 0) rtestLastProgress = micros();
+      radio.startFastWrite(rtestPayload, size, false);
+      rtestPending++;
+    }
+  }
+  r.activeMicros += micros() - sliceStart;
+}
+
+void collectRadioTest(RadioTestResult &r) {
+  // Same accounting as serviceRadioIRQ() - one flag can cover several frames
+  bool txOk, txFail, rxReady;
+  radio.whatHappened(txOk, txFail, rxReady);
+
+  if (txOk && rtestPending > 0) {
+    uint8_t done = getCompletedFrames(rtestPending);
+    r.delivered += done;
+    rtestPending -= done;
+    r.retries += (uint32_t)radio.getARC() * done;
+    rtestLastProgress = micros();
+  }
+  if (txFail) {
+    // Frames queued behind the failed one were never tried - not counted
+    r.failed++;
+    r.retries += radio.getARC();
+    rtestPending = 0;
+    radio.flush_tx();
+    rtestLastProgress = micros();
+  }
+  if (rxReady) radio.flush_rx(); // ACK payloads from the receiver
+}
+
+void finishRadioTestStep() {
+  radio.flush_tx();
+  rtestPending = 0;
+}
+
+void endRadioTest() {
+  // Back to the link configuration, completed or aborted
+  rtestRunning = false;
+  finishRadioTestStep();
+  radio.flush_rx();
+  configureRadio();
+  // Test frames were never link frames - leave no flags behind for serviceRadioIRQ()
+  bool txOk, txFail, rxReady;
+  radio.whatHappened(txOk, txFail, rxReady);
+  radioIrqPending = false;
+}
+
+uint16_t getRadioTestRate(const RadioTestResult &r) {
+  if (r.activeMicros == 0) return 0;
+  return (uint64_t)r.delivered * 1000000UL / r.activeMicros;
+}
+
+uint16_t getRadioTestPERx10(const RadioTestResult &r) {
+  // Packet error rate in 0.1 % steps
+  uint32_t attempts = r.delivered + r.failed;
+  return attempts ? (uint32_t)r.failed * 1000 / attempts : 0;
+}
+
+void printRadioTestResult(uint8_t step) {
+  const RadioTestResult &r = rtestResults[step];
+  uint16_t rate = getRadioTestRate(r);
+  Serial.print(dataRateNames[rtestRates[step / RTEST_SIZES]]);
+  Serial.print(" ");
+  Serial.print(rtestSizes[step % RTEST_SIZES]);
+  Serial.print("B: ");
+  Serial.print(rate);
+  Serial.print(" frames/s, ");
+  Serial.print((uint32_t)rate * rtestSizes[step % RTEST_SIZES] * 8 / 1000);
+  Serial.print(" kbit/s, ");
+  Serial.print(r.failed);
+  Serial.print(" failed");
+#if RADIO_ACK_TELEMETRY
+  Serial.print(", PER ");
+  Serial.print(getRadioTestPERx10(r) / 10.0, 1);
+  Serial.print("%, retries/frame ");
+  Serial.print(r.delivered ? (float)r.retries / r.delivered : 0.0, 2);
+#endif
+  Serial.println();
+}
+
+bool isRadioTestActive() {
+  return currentMenu == MENU_RADIO_TEST;
+}
+
+bool isRadioTestRunning() {
+  return rtestRunning;
+}
+
+void drawRadioTest() {
+  display.setTextSize(1);
+  display.setCursor(0, 0);
+  display.print("Radio Test ");
+  display.print(dataRateNames[rtestRates[rtestPage]]);
+  if (rtestRunning) {
+    display.print(" ");
+    display.print(rtestStep + 1);
+    display.print("/");
+    display.print(RTEST_STEPS);
+  }
+
+  // One row per payload size of the shown data rate
+  display.setCursor(0, 12);
+  display.print(RADIO_ACK_TELEMETRY ? "Size  f/s  Fail PER" : "Size  f/s  Fail");
+  for (uint8_t i = 0; i < RTEST_SIZES; i++) {
+    uint8_t step = rtestPage * RTEST_SIZES + i;
+    const RadioTestResult &r = rtestResults[step];
+    display.setCursor(0, 22 + i * 10);
+    display.print(rtestSizes[i]);
+    display.print("B");
+    if (step > rtestStep || (step == rtestStep && !rtestRunning)) {
+      display.print("   --");
+      continue;
+    }
+    display.setCursor(30, 22 + i * 10);
+    display.print(getRadioTestRate(r));
+    display.setCursor(66, 22 + i * 10);
+    display.print(r.failed);
+#if RADIO_ACK_TELEMETRY
+    display.setCursor(96, 22 + i * 10);
+    display.print(getRadioTestPERx10(r) / 10.0, 1);
+#endif
+  }
+
+  display.setCursor(0, 57);
+  display.print(rtestRunning ? "Running... <:Abort" : "OK:Run >:Rate <:Back");
+}
+
+#endif
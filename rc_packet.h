@@ -0,0 +1,415 @@
+/*
+  rc_packet.h - Versioned bit-packed channel packet format
+  RC Transmitter for Arduino Mega
+
+  Only depends on <stdint.h>/<string.h> so the encoder and decoder can be
+  compiled and tested on a PC as well as shared with the receiver sketch.
+  Nothing here allocates - all buffers are supplied by the caller.
+
+  Packet layout (version 1, little-endian bit order like SBUS/CRSF):
+    byte 0      [version:4][frame type:4]
+    byte 1      sequence number (low 8 bits of data.counter)
+    byte 2      [flags:4][channel count - 1:4]
+    byte 3..    channels, 11 bits each, LSB first
+    last byte   CRC-8 (poly 0xD5) over all preceding bytes
+
+  Channel values -1000..+1000 are sent as value + 1024 (24..2024), so the
+  round trip is exact. 16 channels fit in 26 bytes, which is still smaller
+  than the fixed 32-byte payload the legacy RCData frame is padded to.
+
+  Redundant frame types (the receiver can rebuild a single lost frame):
+    RC_FRAME_CHANNELS_DELTA - a channel frame followed by one byte holding
+      the delta width W (0-12), then one zigzag-coded W-bit delta per
+      channel (previous frame minus this one), then the CRC. W = 0 means
+      the previous frame carried the same values. At most 8 channels fit
+      the 32-byte nRF24 payload in this frame type with the trailers below.
+    RC_FRAME_PARITY - byte 1 is the sequence of the last frame covered and
+      byte 2 is [group size - 1:4][channel count - 1:4]. The channel bytes
+      are the XOR of the channel bytes of the covered frames, so one
+      missing frame of the group is the XOR of the parity and the others.
+
+  Subframes (RC_FRAME_SUBFRAME) carry only part of the channel set:
+    byte 2      [flags:4][total channel count - 1:4]
+    byte 3      [aux group size - 1:4][aux group index:4]
+    byte 4..    the RC_SUBFRAME_CRITICAL first channels (steering, throttle),
+                then aux channels 2 + index * size onwards (the last group
+                may be short), 11 bits each, then trailers and CRC.
+    The receiver keeps the last value of every aux channel between groups.
+
+  Flags (high nibble of byte 2, channel frames only). Each flag adds a
+  trailer after the channels (and any delta block), in this order:
+    RC_FLAG_LINK_CONFIG - 2 bytes: new data rate (rf24_datarate_e) and the
+      sequence of the first frame sent at that rate (link_adapt.h).
+    RC_FLAG_TIMESTAMP - a 4-byte little-endian transmitter micros() value.
+      The receiver echoes it back in TelemetryData::echoTimestamp for
+      round-trip measurement.
+*/
+
+#ifndef RC_PACKET_H
+#define RC_PACKET_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Packet format constants
+#define RC_PACKET_VERSION 1
+#define RC_MAX_CHANNELS 16
+#define RC_PACKET_HEADER_SIZE 3
+#define RC_PACKET_MAX_SIZE (RC_PACKET_HEADER_SIZE + (RC_MAX_CHANNELS * 11 + 7) / 8 + 1)
+#define RC_DELTA_MAX_WIDTH 12    // Zigzag of -2047..2047
+#define RC_TIMESTAMP_SIZE 4
+#define RC_SUBFRAME_HEADER_SIZE 4
+#define RC_SUBFRAME_CRITICAL 2    // Channels 0-1 (steering, throttle) are in every subframe
+#define RC_LINK_CONFIG_SIZE 2
+
+// Flags (high nibble of byte 2)
+#define RC_FLAG_TIMESTAMP 0x10
+#define RC_FLAG_LINK_CONFIG 0x20
+#define RC_CHANNEL_OFFSET 1024   // Added to -1000..1000 before packing
+
+// Frame types (low nibble of byte 0)
+enum RCFrameType {
+  RC_FRAME_CHANNELS = 0,         // Full channel set
+  RC_FRAME_CHANNELS_DELTA = 1,   // Full channel set plus deltas to the previous frame
+  RC_FRAME_PARITY = 2,           // XOR of the channel bytes of the last N frames
+  RC_FRAME_SUBFRAME = 3          // Critical channels plus one rotating aux group
+};
+
+// Function declarations
+uint8_t crc8(const uint8_t* buffer, uint8_t length);
+void packBits(const uint16_t* values, uint8_t count, uint8_t width, uint8_t* out);
+void unpackBits(const uint8_t* in, uint8_t count, uint8_t width, uint16_t* values);
+void packBits11(const uint16_t* values, uint8_t count, uint8_t* out);
+void unpackBits11(const uint8_t* in, uint8_t count, uint16_t* values);
+uint8_t getRCPacketSize(uint8_t channelCount);
+uint8_t getRCChannelBytes(uint8_t channelCount);
+uint16_t getRCRawValue(int16_t value);
+uint8_t getRCSubframeGroups(uint8_t count, uint8_t groupSize);
+uint8_t getRCSubframeAuxCount(uint8_t count, uint8_t groupSize, uint8_t group);
+uint8_t encodeRCPacket(uint8_t* buffer, uint8_t sequence, const int16_t* channels, uint8_t count);
+uint8_t encodeRCDeltaPacket(uint8_t* buffer, uint8_t sequence, const int16_t* channels, const int16_t* previous, uint8_t count);
+uint8_t encodeRCSubframe(uint8_t* buffer, uint8_t sequence, const int16_t* channels, uint8_t count, uint8_t groupSize, uint8_t group);
+uint8_t encodeRCParityPacket(uint8_t* buffer, uint8_t lastSequence, const uint8_t* parity, uint8_t count, uint8_t group);
+void accumulateRCParity(uint8_t* parity, const uint8_t* packet, uint8_t count);
+uint8_t appendRCTimestamp(uint8_t* buffer, uint8_t length, uint32_t timestamp);
+bool getRCTimestamp(const uint8_t* buffer, uint8_t length, uint32_t &timestamp);
+uint8_t appendRCLinkConfig(uint8_t* buffer, uint8_t length, uint8_t dataRate, uint8_t switchSequence);
+bool getRCLinkConfig(const uint8_t* buffer, uint8_t length, uint8_t &dataRate, uint8_t &switchSequence);
+uint8_t getRCBodyLength(const uint8_t* buffer, uint8_t length);
+bool decodeRCPacket(const uint8_t* buffer, uint8_t length, uint8_t &sequence, int16_t* channels, uint8_t &count);
+bool decodeRCPrevious(const uint8_t* buffer, uint8_t length, int16_t* previous);
+bool decodeRCSubframe(const uint8_t* buffer, uint8_t length, uint8_t &sequence, int16_t* channels, uint8_t &count);
+bool decodeRCParityPacket(const uint8_t* buffer, uint8_t length, const uint8_t* received, uint8_t &lastSequence, uint8_t &group, int16_t* channels, uint8_t &count);
+
+uint8_t crc8(const uint8_t* buffer, uint8_t length) {
+  // CRC-8/DVB-S2 (same polynomial as CRSF)
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < length; i++) {
+    crc ^= buffer[i];
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0xD5) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+void packBits(const uint16_t* values, uint8_t count, uint8_t width, uint8_t* out) {
+  uint8_t bytes = (count * width + 7) / 8;
+  memset(out, 0, bytes);
+
+  uint16_t bitPos = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    uint16_t value = values[i];
+    for (uint8_t b = 0; b < width; b++, bitPos++) {
+      if (value & (1 << b)) out[bitPos >> 3] |= (uint8_t)(1 << (bitPos & 7));
+    }
+  }
+}
+
+void unpackBits(const uint8_t* in, uint8_t count, uint8_t width, uint16_t* values) {
+  uint16_t bitPos = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    uint16_t value = 0;
+    for (uint8_t b = 0; b < width; b++, bitPos++) {
+      if (in[bitPos >> 3] & (1 << (bitPos & 7))) value |= (1 << b);
+    }
+    values[i] = value;
+  }
+}
+
+void packBits11(const uint16_t* values, uint8_t count, uint8_t* out) {
+  packBits(values, count, 11, out);
+}
+
+void unpackBits11(const uint8_t* in, uint8_t count, uint16_t* values) {
+  unpackBits(in, count, 11, values);
+}
+
+uint8_t getRCPacketSize(uint8_t channelCount) {
+  return RC_PACKET_HEADER_SIZE + getRCChannelBytes(channelCount) + 1;
+}
+
+uint8_t getRCChannelBytes(uint8_t channelCount) {
+  return (channelCount * 11 + 7) / 8;
+}
+
+uint16_t getRCRawValue(int16_t value) {
+  int16_t raw = value + RC_CHANNEL_OFFSET;
+  if (raw < 0) raw = 0;
+  if (raw > 2047) raw = 2047;
+  return raw;
+}
+
+uint8_t getRCSubframeGroups(uint8_t count, uint8_t groupSize) {
+  if (count <= RC_SUBFRAME_CRITICAL || groupSize == 0) return 1;
+  return (count - RC_SUBFRAME_CRITICAL + groupSize - 1) / groupSize;
+}
+
+uint8_t getRCSubframeAuxCount(uint8_t count, uint8_t groupSize, uint8_t group) {
+  uint16_t start = RC_SUBFRAME_CRITICAL + group * groupSize;
+  if (start >= count) return 0;
+  return (count - start < groupSize) ? count - start : groupSize;
+}
+
+uint8_t encodeRCPacket(uint8_t* buffer, uint8_t sequence, const int16_t* channels, uint8_t count) {
+  if (count < 1) count = 1;
+  if (count > RC_MAX_CHANNELS) count = RC_MAX_CHANNELS;
+
+  uint16_t raw[RC_MAX_CHANNELS];
+  for (uint8_t i = 0; i < count; i++) {
+    raw[i] = getRCRawValue(channels[i]);
+  }
+
+  buffer[0] = (RC_PACKET_VERSION << 4) | RC_FRAME_CHANNELS;
+  buffer[1] = sequence;
+  buffer[2] = count - 1;
+  packBits11(raw, count, buffer + RC_PACKET_HEADER_SIZE);
+
+  uint8_t length = getRCPacketSize(count);
+  buffer[length - 1] = crc8(buffer, length - 1);
+  return length;
+}
+
+uint8_t encodeRCDeltaPacket(uint8_t* buffer, uint8_t sequence, const int16_t* channels, const int16_t* previous, uint8_t count) {
+  uint8_t length = encodeRCPacket(buffer, sequence, channels, count);
+  if (count < 1) count = 1;
+  if (count > RC_MAX_CHANNELS) count = RC_MAX_CHANNELS;
+
+  // Zigzag so small negative deltas stay small, then use the narrowest width
+  uint16_t zigzag[RC_MAX_CHANNELS];
+  uint16_t widest = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    int16_t delta = previous[i] - channels[i];
+    if (delta > 2047) delta = 2047;
+    if (delta < -2047) delta = -2047;
+    zigzag[i] = (uint16_t)((delta << 1) ^ (delta >> 15));
+    widest |= zigzag[i];
+  }
+  uint8_t width = 0;
+  while (widest >> width) width++;
+
+  // Replace the CRC with the delta block, then append a new CRC
+  uint8_t pos = length - 1;
+  buffer[0] = (RC_PACKET_VERSION << 4) | RC_FRAME_CHANNELS_DELTA;
+  buffer[pos++] = width;
+  packBits(zigzag, count, width, buffer + pos);
+  pos += (count * width + 7) / 8;
+  buffer[pos] = crc8(buffer, pos);
+  return pos + 1;
+}
+
+uint8_t encodeRCSubframe(uint8_t* buffer, uint8_t sequence, const int16_t* channels, uint8_t count, uint8_t groupSize, uint8_t group) {
+  if (count < RC_SUBFRAME_CRITICAL) count = RC_SUBFRAME_CRITICAL;
+  if (count > RC_MAX_CHANNELS) count = RC_MAX_CHANNELS;
+  if (groupSize < 1) groupSize = 1;
+
+  uint8_t auxStart = RC_SUBFRAME_CRITICAL + group * groupSize;
+  uint8_t auxCount = getRCSubframeAuxCount(count, groupSize, group);
+  uint8_t sent = RC_SUBFRAME_CRITICAL + auxCount;
+
+  uint16_t raw[RC_MAX_CHANNELS];
+  for (uint8_t i = 0; i < RC_SUBFRAME_CRITICAL; i++) raw[i] = getRCRawValue(channels[i]);
+  for (uint8_t i = 0; i < auxCount; i++) raw[RC_SUBFRAME_CRITICAL + i] = getRCRawValue(channels[auxStart + i]);
+
+  buffer[0] = (RC_PACKET_VERSION << 4) | RC_FRAME_SUBFRAME;
+  buffer[1] = sequence;
+  buffer[2] = count - 1;
+  buffer[3] = ((groupSize - 1) << 4) | (group & 0x0F);
+  packBits11(raw, sent, buffer + RC_SUBFRAME_HEADER_SIZE);
+
+  uint8_t length = RC_SUBFRAME_HEADER_SIZE + getRCChannelBytes(sent) + 1;
+  buffer[length - 1] = crc8(buffer, length - 1);
+  return length;
+}
+
+uint8_t encodeRCParityPacket(uint8_t* buffer, uint8_t lastSequence, const uint8_t* parity, uint8_t count, uint8_t group) {
+  if (count < 1) count = 1;
+  if (count > RC_MAX_CHANNELS) count = RC_MAX_CHANNELS;
+
+  buffer[0] = (RC_PACKET_VERSION << 4) | RC_FRAME_PARITY;
+  buffer[1] = lastSequence;
+  buffer[2] = ((group - 1) << 4) | (count - 1);
+  memcpy(buffer + RC_PACKET_HEADER_SIZE, parity, getRCChannelBytes(count));
+
+  uint8_t length = getRCPacketSize(count);
+  buffer[length - 1] = crc8(buffer, length - 1);
+  return length;
+}
+
+void accumulateRCParity(uint8_t* parity, const uint8_t* packet, uint8_t count) {
+  // Channel bytes sit at the same offset in full and delta frames
+  uint8_t bytes = getRCChannelBytes(count);
+  for (uint8_t i = 0; i < bytes; i++) {
+    parity[i] ^= packet[RC_PACKET_HEADER_SIZE + i];
+  }
+}
+
+uint8_t appendRCTimestamp(uint8_t* buffer, uint8_t length, uint32_t timestamp) {
+  // Overwrites the CRC with the timestamp, then appends a new CRC
+  uint8_t pos = length - 1;
+  buffer[2] |= RC_FLAG_TIMESTAMP;
+  for (uint8_t i = 0; i < RC_TIMESTAMP_SIZE; i++) {
+    buffer[pos++] = (uint8_t)(timestamp >> (8 * i));
+  }
+  buffer[pos] = crc8(buffer, pos);
+  return pos + 1;
+}
+
+uint8_t appendRCLinkConfig(uint8_t* buffer, uint8_t length, uint8_t dataRate, uint8_t switchSequence) {
+  // Must be appended before the timestamp
+  uint8_t pos = length - 1;
+  buffer[2] |= RC_FLAG_LINK_CONFIG;
+  buffer[pos++] = dataRate;
+  buffer[pos++] = switchSequence;
+  buffer[pos] = crc8(buffer, pos);
+  return pos + 1;
+}
+
+uint8_t getRCBodyLength(const uint8_t* buffer, uint8_t length) {
+  // Frame length without the optional trailers
+  if ((buffer[0] & 0x0F) == RC_FRAME_PARITY) return length;
+  uint8_t trailers = 0;
+  if (buffer[2] & RC_FLAG_TIMESTAMP) trailers += RC_TIMESTAMP_SIZE;
+  if (buffer[2] & RC_FLAG_LINK_CONFIG) trailers += RC_LINK_CONFIG_SIZE;
+  return length > trailers ? length - trailers : 0;
+}
+
+bool getRCLinkConfig(const uint8_t* buffer, uint8_t length, uint8_t &dataRate, uint8_t &switchSequence) {
+  if ((buffer[0] & 0x0F) == RC_FRAME_PARITY || !(buffer[2] & RC_FLAG_LINK_CONFIG)) return false;
+  uint8_t end = length - 1 - ((buffer[2] & RC_FLAG_TIMESTAMP) ? RC_TIMESTAMP_SIZE : 0);
+  if (end < RC_PACKET_HEADER_SIZE + RC_LINK_CONFIG_SIZE) return false;
+  dataRate = buffer[end - 2];
+  switchSequence = buffer[end - 1];
+  return true;
+}
+
+bool getRCTimestamp(const uint8_t* buffer, uint8_t length, uint32_t &timestamp) {
+  if (length < RC_PACKET_HEADER_SIZE + RC_TIMESTAMP_SIZE + 1) return false;
+  if ((buffer[0] & 0x0F) == RC_FRAME_PARITY || !(buffer[2] & RC_FLAG_TIMESTAMP)) return false;
+
+  timestamp = 0;
+  const uint8_t* pos = buffer + length - 1 - RC_TIMESTAMP_SIZE;
+  for (uint8_t i = 0; i < RC_TIMESTAMP_SIZE; i++) {
+    timestamp |= (uint32_t)pos[i] << (8 * i);
+  }
+  return true;
+}
+
+bool decodeRCPacket(const uint8_t* buffer, uint8_t length, uint8_t &sequence, int16_t* channels, uint8_t &count) {
+  if (length < RC_PACKET_HEADER_SIZE + 1) return false;
+  if ((buffer[0] >> 4) != RC_PACKET_VERSION) return false;
+  uint8_t type = buffer[0] & 0x0F;
+  if (type != RC_FRAME_CHANNELS && type != RC_FRAME_CHANNELS_DELTA) return false;
+
+  count = (buffer[2] & 0x0F) + 1;
+  uint8_t body = getRCBodyLength(buffer, length);
+  if (type == RC_FRAME_CHANNELS && body != getRCPacketSize(count)) return false;
+  if (type == RC_FRAME_CHANNELS_DELTA && body < getRCPacketSize(count) + 1) return false;
+  if (crc8(buffer, length - 1) != buffer[length - 1]) return false;
+
+  uint16_t raw[RC_MAX_CHANNELS];
+  unpackBits11(buffer + RC_PACKET_HEADER_SIZE, count, raw);
+  for (uint8_t i = 0; i < count; i++) {
+    channels[i] = (int16_t)raw[i] - RC_CHANNEL_OFFSET;
+  }
+  sequence = buffer[1];
+  return true;
+}
+
+bool decodeRCPrevious(const uint8_t* buffer, uint8_t length, int16_t* previous) {
+  // Rebuilds frame sequence - 1 from a delta frame
+  uint8_t sequence, count;
+  int16_t channels[RC_MAX_CHANNELS];
+  if ((buffer[0] & 0x0F) != RC_FRAME_CHANNELS_DELTA) return false;
+  if (!decodeRCPacket(buffer, length, sequence, channels, count)) return false;
+
+  uint8_t pos = RC_PACKET_HEADER_SIZE + getRCChannelBytes(count);
+  uint8_t width = buffer[pos++];
+  if (width > RC_DELTA_MAX_WIDTH) return false;
+  if (getRCBodyLength(buffer, length) != pos + (count * width + 7) / 8 + 1) return false;
+
+  uint16_t zigzag[RC_MAX_CHANNELS];
+  unpackBits(buffer + pos, count, width, zigzag);
+  for (uint8_t i = 0; i < count; i++) {
+    int16_t delta = (int16_t)(zigzag[i] >> 1) ^ -(int16_t)(zigzag[i] & 1);
+    previous[i] = channels[i] + delta;
+  }
+  return true;
+}
+
+bool decodeRCSubframe(const uint8_t* buffer, uint8_t length, uint8_t &sequence, int16_t* channels, uint8_t &count) {
+  // Updates the critical channels and this frame's aux group only
+  if (length < RC_SUBFRAME_HEADER_SIZE + 1) return false;
+  if ((buffer[0] >> 4) != RC_PACKET_VERSION) return false;
+  if ((buffer[0] & 0x0F) != RC_FRAME_SUBFRAME) return false;
+
+  count = (buffer[2] & 0x0F) + 1;
+  uint8_t groupSize = (buffer[3] >> 4) + 1;
+  uint8_t group = buffer[3] & 0x0F;
+  uint8_t auxCount = getRCSubframeAuxCount(count, groupSize, group);
+  uint8_t sent = RC_SUBFRAME_CRITICAL + auxCount;
+  if (count < RC_SUBFRAME_CRITICAL) return false;
+  if (getRCBodyLength(buffer, length) != RC_SUBFRAME_HEADER_SIZE + getRCChannelBytes(sent) + 1) return false;
+  if (crc8(buffer, length - 1) != buffer[length - 1]) return false;
+
+  uint16_t raw[RC_MAX_CHANNELS];
+  unpackBits11(buffer + RC_SUBFRAME_HEADER_SIZE, sent, raw);
+  uint8_t auxStart = RC_SUBFRAME_CRITICAL + group * groupSize;
+  for (uint8_t i = 0; i < RC_SUBFRAME_CRITICAL; i++) {
+    channels[i] = (int16_t)raw[i] - RC_CHANNEL_OFFSET;
+  }
+  for (uint8_t i = 0; i < auxCount; i++) {
+    channels[auxStart + i] = (int16_t)raw[RC_SUBFRAME_CRITICAL + i] - RC_CHANNEL_OFFSET;
+  }
+  sequence = buffer[1];
+  return true;
+}
+
+bool decodeRCParityPacket(const uint8_t* buffer, uint8_t length, const uint8_t* received, uint8_t &lastSequence, uint8_t &group, int16_t* channels, uint8_t &count) {
+  // received: accumulateRCParity() of every frame of the group that did arrive.
+  // Only meaningful when exactly one frame of the group is missing.
+  if (length < RC_PACKET_HEADER_SIZE + 1) return false;
+  if ((buffer[0] >> 4) != RC_PACKET_VERSION) return false;
+  if ((buffer[0] & 0x0F) != RC_FRAME_PARITY) return false;
+
+  count = (buffer[2] & 0x0F) + 1;
+  group = (buffer[2] >> 4) + 1;
+  if (length != getRCPacketSize(count)) return false;
+  if (crc8(buffer, length - 1) != buffer[length - 1]) return false;
+
+  uint8_t missing[RC_PACKET_MAX_SIZE];
+  uint8_t bytes = getRCChannelBytes(count);
+  for (uint8_t i = 0; i < bytes; i++) {
+    missing[i] = buffer[RC_PACKET_HEADER_SIZE + i] ^ received[i];
+  }
+
+  uint16_t raw[RC_MAX_CHANNELS];
+  unpackBits11(missing, count, raw);
+  for (uint8_t i = 0; i < count; i++) {
+    channels[i] = (int16_t)raw[i] - RC_CHANNEL_OFFSET;
+  }
+  lastSequence = buffer[1];
+  return true;
+}
+
+#endif
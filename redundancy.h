@@ -0,0 +1,143 @@
+/*
+  redundancy.h - Redundant frames so the receiver can rebuild lost frames
+  RC Transmitter for Arduino Mega
+
+  Without auto-ack a lost frame is never retransmitted. RADIO_REDUNDANCY
+  selects one of two ways for the receiver to rebuild a single loss from
+  frames it did get (frame layouts are documented in rc_packet.h):
+  - REDUNDANCY_DELTA: every frame also carries the previous frame of the
+    same slot as deltas, so frame N-1 is rebuilt from frame N.
+  - REDUNDANCY_PARITY: after every RADIO_PARITY_GROUP frames of a slot an
+    extra parity frame is queued on the same channel, so any one missing
+    frame of the group is rebuilt. With hopping the receiver must wait for
+    the parity frame before retuning after the last frame of a group.
+
+  Bench test: RADIO_TEST_DROP_PERCENT withholds that share of frames
+  (parity frames included) after they are encoded, so the counter gap
+  looks like air loss to the receiver. The transmitter also works out
+  which of the withheld frames the receiver could rebuild, so the
+  effective loss can be compared with the raw loss without a receiver.
+*/
+
+#ifndef REDUNDANCY_H
+#define REDUNDANCY_H
+
+#include "config.h"
+#include "rc_packet.h"
+#include "tdma.h"
+
+#if RADIO_REDUNDANCY != REDUNDANCY_OFF && RADIO_PACKET_FORMAT != PACKET_FORMAT_PACKED
+#error "RADIO_REDUNDANCY needs RADIO_PACKET_FORMAT PACKET_FORMAT_PACKED"
+#endif
+#if RADIO_REDUNDANCY == REDUNDANCY_DELTA && RC_CHANNEL_COUNT > 8
+#error "Delta frames with a link-config trailer only fit a 32-byte payload with up to 8 channels"
+#endif
+
+// Per-slot redundancy state
+int16_t deltaPrevious[TDMA_MAX_SLOTS][RC_CHANNEL_COUNT];
+bool deltaPreviousValid[TDMA_MAX_SLOTS];
+uint8_t parityBytes[TDMA_MAX_SLOTS][RC_PACKET_MAX_SIZE];
+uint8_t parityCount[TDMA_MAX_SLOTS];
+uint8_t parityLastSequence[TDMA_MAX_SLOTS];
+
+// Bench test counters (RADIO_TEST_DROP_PERCENT)
+uint32_t testFrames = 0;
+uint32_t testDropped = 0;
+uint32_t testRecovered = 0;
+bool testPreviousDropped[TDMA_MAX_SLOTS];
+uint8_t testGroupDrops[TDMA_MAX_SLOTS];
+
+// Function declarations
+void resetRedundancy();
+uint8_t encodeRedundantPacket(uint8_t* buffer, uint8_t sequence, uint8_t slot, const int16_t* channels);
+uint8_t takeParityPacket(uint8_t* buffer, uint8_t slot);
+uint8_t getRedundantBytes(uint8_t length);
+bool testDropFrame(uint8_t slot);
+bool testDropParity(uint8_t slot, bool canSend);
+uint8_t getTestEffectiveLossPercent();
+
+void resetRedundancy() {
+  memset(deltaPreviousValid, 0, sizeof(deltaPreviousValid));
+  memset(parityBytes, 0, sizeof(parityBytes));
+  memset(parityCount, 0, sizeof(parityCount));
+  memset(testPreviousDropped, 0, sizeof(testPreviousDropped));
+  memset(testGroupDrops, 0, sizeof(testGroupDrops));
+}
+
+uint8_t encodeRedundantPacket(uint8_t* buffer, uint8_t sequence, uint8_t slot, const int16_t* channels) {
+#if RADIO_REDUNDANCY == REDUNDANCY_DELTA
+  uint8_t length = deltaPreviousValid[slot] ?
+    encodeRCDeltaPacket(buffer, sequence, channels, deltaPrevious[slot], RC_CHANNEL_COUNT) :
+    encodeRCPacket(buffer, sequence, channels, RC_CHANNEL_COUNT);
+  memcpy(deltaPrevious[slot], channels, sizeof(deltaPrevious[slot]));
+  deltaPreviousValid[slot] = true;
+  return length;
+#else
+  uint8_t length = encodeRCPacket(buffer, sequence, channels, RC_CHANNEL_COUNT);
+#if RADIO_REDUNDANCY == REDUNDANCY_PARITY
+  accumulateRCParity(parityBytes[slot], buffer, RC_CHANNEL_COUNT);
+  parityCount[slot]++;
+  parityLastSequence[slot] = sequence;
+#endif
+  return length;
+#endif
+}
+
+uint8_t takeParityPacket(uint8_t* buffer, uint8_t slot) {
+  // Returns the parity frame once a group is complete, otherwise 0
+#if RADIO_REDUNDANCY == REDUNDANCY_PARITY
+  if (parityCount[slot] < RADIO_PARITY_GROUP) return 0;
+  uint8_t length = encodeRCParityPacket(buffer, parityLastSequence[slot], parityBytes[slot],
+                                        RC_CHANNEL_COUNT, RADIO_PARITY_GROUP);
+  memset(parityBytes[slot], 0, sizeof(parityBytes[slot]));
+  parityCount[slot] = 0;
+  return length;
+#else
+  return 0;
+#endif
+}
+
+uint8_t getRedundantBytes(uint8_t length) {
+  // Bytes of a data frame beyond a plain channel frame (the delta block)
+  uint8_t plain = getRCPacketSize(RC_CHANNEL_COUNT);
+  return (RADIO_PACKET_FORMAT == PACKET_FORMAT_PACKED && length > plain) ? length - plain : 0;
+}
+
+bool testDropFrame(uint8_t slot) {
+#if RADIO_TEST_DROP_PERCENT > 0
+  bool dropped = random(100) < RADIO_TEST_DROP_PERCENT;
+  testFrames++;
+  if (dropped) testDropped++;
+
+#if RADIO_REDUNDANCY == REDUNDANCY_DELTA
+  // A dropped frame comes back with the next frame of its slot
+  if (testPreviousDropped[slot] && !dropped) testRecovered++;
+  testPreviousDropped[slot] = dropped;
+#elif RADIO_REDUNDANCY == REDUNDANCY_PARITY
+  if (dropped) testGroupDrops[slot]++;
+#endif
+  return dropped;
+#else
+  return false;
+#endif
+}
+
+bool testDropParity(uint8_t slot, bool canSend) {
+  // canSend is false when the TX FIFO had no room for the parity frame
+#if RADIO_TEST_DROP_PERCENT > 0
+  // Parity frames are lost at the same rate, but are not control frames
+  bool dropped = !canSend || random(100) < RADIO_TEST_DROP_PERCENT;
+  if (!dropped && testGroupDrops[slot] == 1) testRecovered++;
+  testGroupDrops[slot] = 0;
+  return dropped;
+#else
+  return !canSend;
+#endif
+}
+
+uint8_t getTestEffectiveLossPercent() {
+  if (testFrames == 0) return 0;
+  return (testDropped - testRecovered) * 100 / testFrames;
+}
+
+#endif
@@ -0,0 +1,246 @@
+/*
+  scanner.h - 2.4 GHz spectrum scanner
+  RC Transmitter for Arduino Mega
+
+  Sweeps all 126 nRF24 channels with testRPD() (received power > -64 dBm)
+  and accumulates an occupancy histogram. Only SCAN_CHANNELS_PER_PASS
+  channels are sampled per loop() pass so the menu stays responsive.
+  Transmission is paused while scanning, so a scan can only be started
+  while DISARMED and is stopped as soon as the system is armed.
+*/
+
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include "config.h"
+#include "display.h"
+#include "radio.h"
+#include "hopping.h"
+#include "menu_data.h"
+
+// Scanner constants
+#define SCAN_CHANNELS 126
+#define SCAN_CHANNELS_PER_PASS 4      // Channels sampled per updateScanner() call
+#define SCAN_DWELL_MICROS 170         // RX settle time before reading RPD
+#define SCAN_SEED_CANDIDATES 32       // Hop seeds tried when suggesting a hop set
+#define SCAN_BAR_TOP 17               // Bar graph area (blue part of the screen)
+#define SCAN_BAR_HEIGHT 38
+
+// Scanner variables
+bool scannerActive = false;
+uint16_t scanHits[SCAN_CHANNELS];
+uint16_t scanSweeps = 0;
+uint8_t scanChannel = 0;
+uint8_t scanBestChannel = RADIO_CHANNEL;
+uint16_t scanBestSeed = 0;
+bool scanLastOK = false;
+
+// External variables from menu.h
+extern MenuState currentMenu;
+extern int menuSelection;
+extern int menuOffset;
+extern int maxMenuItems;
+extern unsigned long lastNavigation;
+extern unsigned long menuTimer;
+
+// Forward declarations for external functions
+extern int getNavigationDirection();
+
+// Function declarations
+void startScanner();
+void stopScanner();
+void updateScanner();
+void scanNextChannels();
+uint32_t getChannelScore(uint8_t channel);
+uint8_t findBestChannel();
+uint16_t findBestHopSeed();
+void drawScanner();
+bool isScannerActive();
+
+void startScanner() {
+  if (getArmedStatus()) {
+    Serial.println("Spectrum scan blocked - disarm first");
+    return;
+  }
+
+  Serial.println("Starting spectrum scan");
+  memset(scanHits, 0, sizeof(scanHits));
+  scanSweeps = 0;
+  scanChannel = 0;
+  scanBestChannel = getCurrentChannel();
+  scanBestSeed = settings.hopSeed;
+  scanLastOK = buttons.btnOK; // Ignore the OK press that started the scan
+  scannerActive = true;
+
+  // Drop anything still queued so it does not go out on a scan channel
+  discardQueuedFrames();
+}
+
+void stopScanner() {
+  if (!scannerActive) return;
+  scannerActive = false;
+
+  // Back to transmitter mode on the channel the link was using
+  radio.stopListening();
+  radio.flush_rx();
+  radio.setChannel(getCurrentChannel());
+  restartLinkAdapt();
+  Serial.println("Spectrum scan stopped");
+}
+
+void updateScanner() {
+  if (!scannerActive) return;
+
+  // The control link has priority - arming ends the scan
+  if (getArmedStatus()) {
+    stopScanner();
+    currentMenu = MENU_LINK_SETTINGS;
+    maxMenuItems = 14;
+    return;
+  }
+
+  scanNextChannels();
+  menuTimer = millis(); // Do not auto-exit the menu during a scan
+
+  // OK - apply the best single channel
+  bool currentOK = buttons.btnOK;
+  if (currentOK && !scanLastOK && scanSweeps > 0) {
+    settings.radioChannel = scanBestChannel;
+    saveSettings();
+    Serial.print("Scanner: radio channel set to ");
+    Serial.println(scanBestChannel);
+  }
+  scanLastOK = currentOK;
+
+  if (millis() - lastNavigation < NAV_DEBOUNCE) return;
+  int navDirection = getNavigationDirection();
+  if (navDirection == 2 && scanSweeps > 0) { // Right - apply the best hop set
+    scanBestSeed = findBestHopSeed();
+    settings.hopSeed = scanBestSeed;
+    saveSettings();
+    Serial.print("Scanner: hop seed set to 0x");
+    Serial.println(scanBestSeed, HEX);
+    lastNavigation = millis();
+  } else if (navDirection == -2) { // Left - back to Link Settings
+    stopScanner();
+    currentMenu = MENU_LINK_SETTINGS;
+    maxMenuItems = 14;
+    menuSelection = 0;
+    menuOffset = 0;
+    lastNavigation = millis();
+  }
+}
+
+void scanNextChannels() {
+  for (uint8_t i = 0; i < SCAN_CHANNELS_PER_PASS; i++) {
+    radio.setChannel(scanChannel);
+    radio.startListening();
+    delayMicroseconds(SCAN_DWELL_MICROS);
+    bool busy = radio.testRPD();
+    radio.stopListening();
+
+    if (busy && scanHits[scanChannel] < 0xFFFF) scanHits[scanChannel]++;
+
+    scanChannel++;
+    if (scanChannel >= SCAN_CHANNELS) {
+      scanChannel = 0;
+      if (scanSweeps < 0xFFFF) scanSweeps++;
+      scanBestChannel = findBestChannel();
+    }
+  }
+  radio.flush_rx(); // Other transmitters may have filled the RX FIFO
+}
+
+uint32_t getChannelScore(uint8_t channel) {
+  // A 2 Mbps signal spreads over about 2 MHz, so neighbours count too
+  static const uint8_t weights[5] = {1, 2, 4, 2, 1};
+  uint32_t score = 0;
+  for (int8_t d = -2; d <= 2; d++) {
+    int c = channel + d;
+    if (c < 0 || c >= SCAN_CHANNELS) continue;
+    score += (uint32_t)scanHits[c] * weights[d + 2];
+  }
+  return score;
+}
+
+uint8_t findBestChannel() {
+  // Only suggest channels inside the 2.4 GHz ISM band (same range as hopping)
+  uint8_t best = HOP_CHANNEL_MIN;
+  uint32_t bestScore = 0xFFFFFFFF;
+  for (uint8_t c = HOP_CHANNEL_MIN; c < HOP_CHANNEL_MIN + HOP_CHANNEL_SPAN; c++) {
+    uint32_t score = getChannelScore(c);
+    if (score < bestScore) {
+      bestScore = score;
+      best = c;
+    }
+  }
+  return best;
+}
+
+uint16_t findBestHopSeed() {
+  // Try a batch of seeds and keep the one whose hop table sees the least traffic
+  uint8_t table[HOP_TABLE_SIZE];
+  uint16_t bestSeed = settings.hopSeed;
+  uint32_t bestScore = 0xFFFFFFFF;
+
+  randomSeed(micros());
+  for (uint8_t i = 0; i < SCAN_SEED_CANDIDATES; i++) {
+    uint16_t seed = (i == 0) ? settings.hopSeed : random(1, 65536);
+    generateHopTable(seed, table);
+
+    uint32_t score = 0;
+    for (uint8_t h = 0; h < HOP_TABLE_SIZE; h++) {
+      score += getChannelScore(table[h]);
+    }
+    if (score < bestScore) {
+      bestScore = score;
+      bestSeed = seed;
+    }
+  }
+  return bestSeed;
+}
+
+bool isScannerActive() {
+  return scannerActive;
+}
+
+void drawScanner() {
+  display.setTextSize(1);
+  display.setCursor(0, 0);
+  display.print("Scan #");
+  display.print(scanSweeps);
+  display.print(" Best:");
+  display.print(scanBestChannel);
+
+  display.setCursor(0, 8);
+  display.print("Now:");
+  display.print(getCurrentChannel());
+  display.print(" Busy:");
+  display.print(scanSweeps ? (uint32_t)scanHits[getCurrentChannel()] * 100 / scanSweeps : 0);
+  display.print("%");
+
+  // Scale bars to the busiest channel so light traffic is still visible
+  uint16_t maxHits = 1;
+  for (uint8_t c = 0; c < SCAN_CHANNELS; c++) {
+    if (scanHits[c] > maxHits) maxHits = scanHits[c];
+  }
+
+  // One pixel column per channel, offset by 1 to centre 126 columns on 128
+  for (uint8_t c = 0; c < SCAN_CHANNELS; c++) {
+    int height = (uint32_t)scanHits[c] * SCAN_BAR_HEIGHT / maxHits;
+    if (height > 0) {
+      display.drawLine(c + 1, SCAN_BAR_TOP + SCAN_BAR_HEIGHT - height,
+                       c + 1, SCAN_BAR_TOP + SCAN_BAR_HEIGHT - 1, SSD1306_WHITE);
+    }
+  }
+
+  // Mark the suggested channel and the sweep position under the graph
+  display.drawPixel(scanBestChannel + 1, SCAN_BAR_TOP + SCAN_BAR_HEIGHT, SSD1306_WHITE);
+  display.drawPixel(scanBestChannel + 1, SCAN_BAR_TOP + SCAN_BAR_HEIGHT + 1, SSD1306_WHITE);
+  display.drawPixel(scanChannel + 1, SCAN_BAR_TOP - 1, SSD1306_WHITE);
+
+  display.setCursor(0, 57);
+  display.print("OK:Ch >:Hop <:Back");
+}
+
+#endif
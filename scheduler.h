@@ -0,0 +1,198 @@
+/*
+  scheduler.h - Deadline-based cooperative task scheduler
+  RC Transmitter for Arduino Mega
+
+  loop() runs the static task table below once per pass. Tasks are listed
+  in priority order, and each has a period (0 = every pass) and a time
+  budget. Input sampling comes first so every frame carries the latest
+  sticks, then the radio transmit, then everything else.
+
+  Deadline rule: a task below TASK_RADIO only starts when its budget fits
+  in the time left before the next radio frame is due - otherwise it is
+  deferred to a later pass. Straight after a frame the slack is as large
+  as it gets, so work that does not fit there never will: the first such
+  task that is due runs right then, one per frame, and everything after
+  it is held to the slack that is left. As long as input sampling and
+  the transmit fit in a frame interval, radio jitter is then bounded by
+  the largest budget instead of by whichever tasks happened to be due
+  (tests/scheduler_test.cpp).
+
+  Long work is split so its budget stays small: the display push goes out
+  in chunks (display.h, TASK_DISPLAY_PUSH), and console dumps such as the
+  status dump a section at a time, only as fast as the Serial TX buffer
+  drains (serial_trainer.h, TASK_CONSOLE). Blocking work the scheduler
+  cannot split - an EEPROM save from the menu - shows up in the overrun
+  counters, together with each task's runs, deferrals, worst duration and
+  worst start delay (#sched on the serial console, a console dump with
+  one task per section).
+*/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "config.h"
+
+// Task IDs - also the priority order
+enum TaskId {
+  TASK_INPUT,         // Trainer / sticks, buttons, packet rate, PPM and serial outputs
+  TASK_RADIO,         // transmitData() at getTransmitInterval()
+  TASK_HEALTH,        // Radio health monitor
+  TASK_MENU,          // Menu navigation and actions
+  TASK_DISPLAY,       // Draw the next frame into the display buffer
+  TASK_DISPLAY_PUSH,  // Send the display buffer in chunks
+  TASK_LEDS,          // Status LED
+  TASK_DEBUG,         // Starts the status dump
+  TASK_CONSOLE,       // Sends the running console dump as the TX buffer drains
+  SCHED_TASKS
+};
+
+struct Task {
+  const char* name;
+  void (*run)();
+  unsigned long period;      // us between starts, 0 = every pass
+  unsigned long budget;      // us the task is expected to take
+  bool enabled;
+  unsigned long lastRun;     // micros() at the last start
+  uint32_t runs;
+  uint32_t overruns;         // Took longer than the budget
+  uint32_t deferred;         // Held back for the next radio frame
+  unsigned long worstMicros;
+  unsigned long worstLate;   // Worst start delay after the task was due (us)
+};
+
+// Task functions (Tx_Code_v2.ino)
+extern void taskInput();
+extern void taskRadio();
+extern void taskHealth();
+extern void taskMenu();
+extern void taskDisplay();
+extern void taskDisplayPush();
+extern void taskLEDs();
+extern void taskDebug();
+extern void taskConsole();
+
+Task tasks[SCHED_TASKS] = {
+  {"input",   taskInput,       0,                        1000,  true},
+  {"radio",   taskRadio,       20000,                    1500,  true},
+  {"health",  taskHealth,      0,                        500,   true},
+  {"menu",    taskMenu,        0,                        1000,  true},
+  {"display", taskDisplay,     DISPLAY_INTERVAL * 1000UL, 3000, true},
+  {"push",    taskDisplayPush, 0,                        2000,  false},
+  {"leds",    taskLEDs,        20000,                    200,   true},
+  {"debug",   taskDebug,       10000000UL,               200,   true},
+  {"console", taskConsole,     0,                        500,   false}
+};
+
+uint32_t schedPasses = 0;
+
+// Function declarations
+void initScheduler();
+void runScheduler();
+uint8_t runLongTask();
+bool isTaskDue(const Task &t, unsigned long now);
+void runTask(Task &t, unsigned long now);
+unsigned long getRadioSlack(unsigned long now);
+void setTaskEnabled(uint8_t id, bool enabled);
+void setTaskPeriod(uint8_t id, unsigned long period);
+void shiftTask(uint8_t id, long shift);
+bool printSchedulerSection(Print &out, uint16_t section);
+
+void initScheduler() {
+  // Periods count from the end of setup(), not from power-up
+  unsigned long now = micros();
+  for (uint8_t i = 0; i < SCHED_TASKS; i++) tasks[i].lastRun = now;
+}
+
+void runScheduler() {
+  uint8_t longTask = SCHED_TASKS;   // Ran straight after this pass's frame
+  schedPasses++;
+
+  for (uint8_t i = 0; i < SCHED_TASKS; i++) {
+    Task &t = tasks[i];
+    unsigned long now = micros();
+    if (!t.enabled || i == longTask || !isTaskDue(t, now)) continue;
+
+    if (i > TASK_RADIO && getRadioSlack(now) < t.budget) {
+      t.deferred++;
+      continue;
+    }
+
+    runTask(t, now);
+    if (i == TASK_RADIO) longTask = runLongTask();
+  }
+}
+
+uint8_t runLongTask() {
+  // The slack is at its largest now - the first due task that does not fit
+  // in it never will, so it gets the time before the next frame
+  unsigned long now = micros();
+  unsigned long slack = getRadioSlack(now);
+  for (uint8_t i = TASK_RADIO + 1; i < SCHED_TASKS; i++) {
+    Task &t = tasks[i];
+    if (t.enabled && t.budget > slack && isTaskDue(t, now)) {
+      runTask(t, now);
+      return i;
+    }
+  }
+  return SCHED_TASKS;
+}
+
+bool isTaskDue(const Task &t, unsigned long now) {
+  // Signed - a frame sync shift can put lastRun slightly in the future
+  return t.period == 0 || (long)(now - t.lastRun) >= (long)t.period;
+}
+
+void runTask(Task &t, unsigned long now) {
+  unsigned long late = t.period != 0 ? now - t.lastRun - t.period : 0;
+  if (late > t.worstLate) t.worstLate = late;
+  t.lastRun = now;
+  t.run();
+
+  unsigned long elapsed = micros() - now;
+  t.runs++;
+  if (elapsed > t.worstMicros) t.worstMicros = elapsed;
+  if (elapsed > t.budget) t.overruns++;
+}
+
+unsigned long getRadioSlack(unsigned long now) {
+  // Time until the next radio frame is due - unlimited while the link is off
+  const Task &radioTask = tasks[TASK_RADIO];
+  if (!radioTask.enabled) return 0xFFFFFFFFUL;
+  long since = (long)(now - radioTask.lastRun);
+  return since >= (long)radioTask.period ? 0 : radioTask.period - since;
+}
+
+void setTaskEnabled(uint8_t id, bool enabled) {
+  Task &t = tasks[id];
+  // A task switched on is due at once, without counting the time it was off as late
+  if (enabled && !t.enabled) t.lastRun = micros() - t.period;
+  t.enabled = enabled;
+}
+
+void setTaskPeriod(uint8_t id, unsigned long period) {
+  tasks[id].period = period;
+}
+
+void shiftTask(uint8_t id, long shift) {
+  // Moves the next start of a periodic task (frame sync, frame_sync.h)
+  tasks[id].lastRun += shift;
+}
+
+bool printSchedulerSection(Print &out, uint16_t section) {
+  // Console dump source - header, then one task per section
+  if (section == 0) {
+    out.print("Scheduler: "); out.print(schedPasses); out.println(" passes");
+    return true;
+  }
+  if (section > SCHED_TASKS) return false;
+  const Task &t = tasks[section - 1];
+  out.print("  "); out.print(t.name);
+  out.print(": "); out.print(t.runs); out.print(" runs, ");
+  out.print(t.overruns); out.print(" overruns, ");
+  out.print(t.deferred); out.print(" deferred, worst ");
+  out.print(t.worstMicros); out.print("/"); out.print(t.budget);
+  out.print(" us, late "); out.print(t.worstLate); out.println(" us");
+  return true;
+}
+
+#endif
@@ -0,0 +1,210 @@
+/*
+  serial_output.h - SBUS / CRSF output on Serial1
+  RC Transmitter for Arduino Mega
+
+  Encodes the channel set into SBUS or CRSF frames on Serial1 for external
+  RF modules (ELRS, Crossfire, FrSky and similar), from the same calibrated
+  channel values the radio sends (uiSnapshot, control_isr.h). Selected with the
+  Output setting (OUTPUT_SBUS / OUTPUT_CRSF), alongside or instead of the
+  nRF24.
+
+  Both protocols carry 16 channels of 11 bits, packed LSB first - the same
+  bit order as rc_packet.h, so packBits11() builds the payload (and the
+  CRSF CRC is rc_packet.h's CRC-8/DVB-S2). Channel values map -1000..+1000
+  to 172..1811 (992 centre, 988..2012 us on the receiver). Channels beyond
+  RC_CHANNEL_COUNT are sent centred.
+
+  SBUS: 25 bytes (0x0F, 22 channel bytes, flags, 0x00) every SBUS_INTERVAL
+  at 100000 baud 8E2. SBUS is an inverted UART and the Mega USART cannot
+  invert its output, so TX1 needs an external inverter (one NPN transistor
+  or a 74HC04 gate) in front of the module.
+
+  CRSF: 26 bytes (address, length, type 0x16, 22 channel bytes, CRC-8
+  poly 0xD5 over type + payload) every CRSF_INTERVAL, not inverted. The
+  native 420000 baud is 4.8 % off on a 16 MHz clock, so the port runs at
+  400000 (exact with U2X), which ELRS / Crossfire modules accept. Output
+  only - telemetry coming back on RX1 is not read.
+
+  Frames are handed to the HardwareSerial TX buffer, which the UDRE
+  interrupt drains, so loop() never waits on the wire. A frame that does
+  not fit in the buffer is skipped and counted rather than blocking. When
+  the output is switched off or changed, frames stop and the port is only
+  closed once the last one has left the UART (isSerialOutputDrained()),
+  so the module never sees half a frame and end() has nothing to wait
+  for - at most one full buffer, about 7 ms at 100000 baud 8E2. The
+  encode time per frame is measured on every frame and benchmarked over
+  SERIAL_BENCH_FRAMES frames when the output starts.
+*/
+
+#ifndef SERIAL_OUTPUT_H
+#define SERIAL_OUTPUT_H
+
+#include "config.h"
+#include "rc_packet.h"
+#include "control_isr.h"
+
+// Serial protocol constants
+#define SERIAL_OUT_CHANNELS 16
+#define SERIAL_OUT_CENTER 992
+#define SERIAL_OUT_MIN 172
+#define SERIAL_OUT_MAX 1811
+#define SERIAL_OUT_MAX_FRAME 26
+#define SERIAL_BENCH_FRAMES 100       // Frames encoded by the start-up benchmark
+
+#define SBUS_BAUD 100000
+#define SBUS_FRAME_SIZE 25
+#define SBUS_INTERVAL 14000           // us between frames (7000 for high-speed receivers)
+#define SBUS_HEADER 0x0F
+#define SBUS_FOOTER 0x00
+
+#define CRSF_BAUD 400000
+#define CRSF_FRAME_SIZE 26
+#define CRSF_INTERVAL 4000            // us between frames (250 Hz)
+#define CRSF_ADDRESS_MODULE 0xEE
+#define CRSF_FRAMETYPE_RC_CHANNELS 0x16
+
+// Serial output state
+uint8_t serialOutProtocol = 0;        // OUTPUT_SBUS, OUTPUT_CRSF or 0 when stopped
+uint8_t serialOutFrame[SERIAL_OUT_MAX_FRAME];
+unsigned long lastSerialFrame = 0;
+uint32_t serialFramesSent = 0;
+bool serialOutWritten = false;        // A frame went out since the port was opened
+uint32_t serialFramesSkipped = 0;     // TX buffer still full at frame time
+unsigned long lastSerialEncodeMicros = 0;
+unsigned long worstSerialEncodeMicros = 0;
+unsigned long serialEncodeMicrosTotal = 0;
+uint16_t serialBenchMicrosX10 = 0;    // Benchmarked encode time per frame in 0.1 us steps
+
+// Forward declare settings getter
+extern uint8_t getOutputMode();
+
+// Function declarations
+void startSerialOutput(uint8_t protocol);
+void stopSerialOutput();
+void updateSerialOutput();
+bool isSerialOutputDrained();
+uint8_t encodeSerialFrame(uint8_t protocol, uint8_t* buffer);
+uint8_t encodeSBUSFrame(uint8_t* buffer, const uint16_t* raw);
+uint8_t encodeCRSFFrame(uint8_t* buffer, const uint16_t* raw);
+uint16_t getSerialChannelValue(int16_t value);
+void benchmarkSerialEncoder();
+unsigned long getSerialEncodeAverage();
+const char* getSerialProtocolName();
+
+void startSerialOutput(uint8_t protocol) {
+  if (protocol == OUTPUT_SBUS) {
+    Serial1.begin(SBUS_BAUD, SERIAL_8E2);
+  } else {
+    Serial1.begin(CRSF_BAUD, SERIAL_8N1);
+  }
+  serialOutProtocol = protocol;
+  serialOutWritten = false;
+  lastSerialFrame = micros();
+  worstSerialEncodeMicros = 0;
+  Serial.print(getSerialProtocolName());
+  Serial.println(" output started on Serial1");
+  benchmarkSerialEncoder();
+}
+
+void stopSerialOutput() {
+  // Only called once isSerialOutputDrained() - end() would flush() otherwise
+  Serial1.end();
+  Serial.print(getSerialProtocolName());
+  Serial.println(" output stopped");
+  serialOutProtocol = 0;
+}
+
+void updateSerialOutput() {
+  uint8_t wanted = getOutputMode() & (OUTPUT_SBUS | OUTPUT_CRSF);
+  if (wanted != serialOutProtocol) {
+    // No new frames while the last ones drain - checked again next pass
+    if (serialOutProtocol) {
+      if (!isSerialOutputDrained()) return;
+      stopSerialOutput();
+    }
+    if (wanted) startSerialOutput(wanted);
+  }
+  if (!serialOutProtocol) return;
+
+  unsigned long interval = serialOutProtocol == OUTPUT_SBUS ? SBUS_INTERVAL : CRSF_INTERVAL;
+  unsigned long now = micros();
+  if (now - lastSerialFrame < interval) return;
+  lastSerialFrame = now;
+
+  unsigned long start = micros();
+  uint8_t length = encodeSerialFrame(serialOutProtocol, serialOutFrame);
+  lastSerialEncodeMicros = micros() - start;
+  if (lastSerialEncodeMicros > worstSerialEncodeMicros) worstSerialEncodeMicros = lastSerialEncodeMicros;
+  serialEncodeMicrosTotal += lastSerialEncodeMicros;
+
+  // Never wait for the UART - a frame that does not fit is dropped whole
+  if (Serial1.availableForWrite() < length) {
+    serialFramesSkipped++;
+    return;
+  }
+  Serial1.write(serialOutFrame, length);
+  serialOutWritten = true;
+  serialFramesSent++;
+}
+
+bool isSerialOutputDrained() {
+  // TX buffer empty and the last byte out of the shift register (TXC1 is
+  // cleared on every write, so it is only meaningful once a frame went out)
+  if (Serial1.availableForWrite() < SERIAL_TX_BUFFER_SIZE - 1) return false;
+  return !serialOutWritten || bit_is_set(UCSR1A, TXC1);
+}
+
+uint8_t encodeSerialFrame(uint8_t protocol, uint8_t* buffer) {
+  uint16_t raw[SERIAL_OUT_CHANNELS];
+  for (uint8_t i = 0; i < SERIAL_OUT_CHANNELS; i++) {
+    raw[i] = i < RC_CHANNEL_COUNT ? getSerialChannelValue(uiSnapshot.channels[i]) : SERIAL_OUT_CENTER;
+  }
+  return protocol == OUTPUT_SBUS ? encodeSBUSFrame(buffer, raw) : encodeCRSFFrame(buffer, raw);
+}
+
+uint8_t encodeSBUSFrame(uint8_t* buffer, const uint16_t* raw) {
+  buffer[0] = SBUS_HEADER;
+  packBits11(raw, SERIAL_OUT_CHANNELS, buffer + 1);
+  buffer[23] = 0; // Flags: digital channels 17/18, frame lost, failsafe - all clear
+  buffer[24] = SBUS_FOOTER;
+  return SBUS_FRAME_SIZE;
+}
+
+uint8_t encodeCRSFFrame(uint8_t* buffer, const uint16_t* raw) {
+  buffer[0] = CRSF_ADDRESS_MODULE;
+  buffer[1] = CRSF_FRAME_SIZE - 2; // Type + payload + CRC
+  buffer[2] = CRSF_FRAMETYPE_RC_CHANNELS;
+  packBits11(raw, SERIAL_OUT_CHANNELS, buffer + 3);
+  buffer[25] = crc8(buffer + 2, CRSF_FRAME_SIZE - 3);
+  return CRSF_FRAME_SIZE;
+}
+
+uint16_t getSerialChannelValue(int16_t value) {
+  long raw = SERIAL_OUT_CENTER + (long)value * 820 / 1000;
+  return constrain(raw, SERIAL_OUT_MIN, SERIAL_OUT_MAX);
+}
+
+void benchmarkSerialEncoder() {
+  // micros() only has 4 us resolution - time a batch for the per-frame cost
+  uint8_t frame[SERIAL_OUT_MAX_FRAME];
+  unsigned long start = micros();
+  for (uint8_t i = 0; i < SERIAL_BENCH_FRAMES; i++) {
+    encodeSerialFrame(serialOutProtocol, frame);
+  }
+  serialBenchMicrosX10 = (micros() - start) * 10 / SERIAL_BENCH_FRAMES;
+  Serial.print(getSerialProtocolName());
+  Serial.print(" encode: ");
+  Serial.print(serialBenchMicrosX10 / 10.0, 1);
+  Serial.println(" us/frame");
+}
+
+unsigned long getSerialEncodeAverage() {
+  return serialFramesSent + serialFramesSkipped ?
+         serialEncodeMicrosTotal / (serialFramesSent + serialFramesSkipped) : 0;
+}
+
+const char* getSerialProtocolName() {
+  return serialOutProtocol == OUTPUT_SBUS ? "SBUS" : "CRSF";
+}
+
+#endif
@@ -0,0 +1,333 @@
+/*
+  serial_trainer.h - Serial trainer input and console commands
+  RC Transmitter for Arduino Mega
+
+  Lets a PC supply the channel values over the USB Serial port, for
+  automated testing and simulator-in-the-loop work. While frames keep
+  arriving they replace readJoysticks() as the source of channels[] and
+  data; TRAINER_TIMEOUT without a good frame falls back to the sticks.
+  Arming stays on the left trigger - while DISARMED the stick channels are
+  forced to neutral exactly as for stick input.
+
+  Frame (before COBS encoding):
+  - byte 0: TRAINER_FRAME_CHANNELS
+  - byte 1: sequence, incremented by the PC for every frame (gaps count as lost)
+  - RC_CHANNEL_COUNT channels, int16 little endian, -1000..+1000 in CH_* order
+  - CRC-8 (rc_packet.h crc8) over everything before it
+  On the wire the frame is COBS encoded and ended with a 0x00 byte, so a
+  lost or corrupted byte only costs the frame it lands in. 21 bytes per
+  frame gives about 550 frames/s at 115200 baud. tools/serial_trainer.py
+  is a reference sender.
+
+  Lines starting with '#' at a frame boundary (after a 0x00) and ending in
+  '\n' are console commands - the first COBS code byte of a trainer frame
+  is never above 0x14, so '#' cannot start a frame:
+  - #status   print the system status (console dump, see below)
+  - #trainer  print the trainer input statistics (console dump)
+  - #sched    print the task scheduler statistics (console dump)
+  - #prof     print the section profile (console dump), "#prof reset"
+              clears it
+  - #trace    dump the event trace, "#trace clear" empties it
+
+  Console dumps: long output such as the status dump is not printed in
+  one go - at 115200 baud 600 bytes would hold loop() for 50 ms, several
+  radio frames. A dump source formats one section (a line or a few) into
+  consoleLine when asked, and updateConsole() (TASK_CONSOLE) hands it to
+  Serial only as far as availableForWrite() allows, so it never waits on
+  the UART. One dump runs at a time (status, #trainer, #sched, #prof,
+  #trace, ping histogram); the periodic status dump is skipped while
+  another is running.
+
+  The parser is a byte-at-a-time state machine that takes at most
+  TRAINER_MAX_BYTES per loop() pass, so a flood of input cannot starve
+  transmitData(). The 64-byte Serial RX buffer holds about 5 ms at
+  115200 baud - frames lost to a long display push show as errors.
+*/
+
+#ifndef SERIAL_TRAINER_H
+#define SERIAL_TRAINER_H
+
+#include "config.h"
+#include "rc_packet.h"
+#include "controls.h"
+#include "profiler.h"
+#include "trace.h"
+
+// Serial trainer constants
+#define TRAINER_FRAME_CHANNELS 0x01
+#define TRAINER_FRAME_SIZE (2 + RC_CHANNEL_COUNT * 2 + 1)
+#define TRAINER_BUFFER_SIZE 32        // Decoded bytes - longer frames are discarded
+#define TRAINER_COMMAND_SIZE 24
+#define TRAINER_TIMEOUT 100           // ms without a good frame before the sticks take over
+#define TRAINER_MAX_BYTES 64          // Bytes parsed per loop() pass
+#define CONSOLE_LINE_SIZE 192         // Largest console dump section
+
+// Serial trainer state
+uint8_t trainerBuffer[TRAINER_BUFFER_SIZE];
+uint8_t trainerLength = 0;
+uint8_t trainerBlockRemaining = 0;    // COBS data bytes left in the current block
+uint8_t trainerBlockCode = 0;         // Code byte of the current block, 0 at a frame start
+bool trainerOverflow = false;
+char trainerCommand[TRAINER_COMMAND_SIZE];
+uint8_t trainerCommandLength = 0;
+bool trainerInCommand = false;
+
+int16_t trainerChannels[RC_CHANNEL_COUNT];
+bool trainerActive = false;
+unsigned long lastTrainerFrame = 0;
+uint8_t trainerLastSequence = 0;
+uint32_t trainerFrames = 0;
+uint32_t trainerErrors = 0;           // Bad length, CRC or overflow
+uint32_t trainerLost = 0;             // Sequence gaps
+uint16_t trainerTimeouts = 0;
+uint16_t trainerRate = 0;             // Good frames in the last second
+uint16_t trainerRateCount = 0;
+unsigned long trainerRateStart = 0;
+
+// Console dump source - prints section n into out, false once past the last
+typedef bool (*ConsoleSource)(Print &out, uint16_t section);
+
+// Holds one dump section until the Serial TX buffer has taken all of it
+class ConsoleLine : public Print {
+ public:
+  uint8_t text[CONSOLE_LINE_SIZE];
+  uint8_t length = 0;
+  uint8_t sent = 0;
+
+  using Print::write;
+  size_t write(uint8_t b) {
+    if (length >= CONSOLE_LINE_SIZE) return 0; // Section too long - cut short
+    text[length++] = b;
+    return 1;
+  }
+};
+
+ConsoleLine consoleLine;
+ConsoleSource consoleSource = NULL;   // Running dump, NULL when idle
+uint16_t consoleSection = 0;
+
+// Forward declare status dumps (Tx_Code_v2.ino, scheduler.h)
+extern bool printStatusSection(Print &out, uint16_t section);
+extern bool printSchedulerSection(Print &out, uint16_t section);
+
+// Function declarations
+void updateSerialTrainer();
+void parseTrainerByte(uint8_t b);
+void appendTrainerByte(uint8_t b);
+void endTrainerFrame();
+bool decodeTrainerFrame(const uint8_t* frame, uint8_t length);
+void handleSerialCommand(const char* command);
+bool startConsoleDump(ConsoleSource source);
+void updateConsole();
+bool isConsoleBusy();
+void applyTrainerInput();
+bool isTrainerActive();
+void printTrainerStats(Print &out);
+bool printTrainerSection(Print &out, uint16_t section);
+
+void updateSerialTrainer() {
+  for (uint8_t n = 0; n < TRAINER_MAX_BYTES && Serial.available() > 0; n++) {
+    parseTrainerByte(Serial.read());
+  }
+
+  unsigned long now = millis();
+  if (now - trainerRateStart >= 1000) {
+    trainerRate = trainerRateCount;
+    trainerRateCount = 0;
+    trainerRateStart = now;
+  }
+
+  if (trainerActive && now - lastTrainerFrame >= TRAINER_TIMEOUT) {
+    trainerActive = false;
+    trainerTimeouts++;
+    Serial.println("Trainer input timed out - back to sticks");
+  }
+}
+
+void parseTrainerByte(uint8_t b) {
+  if (trainerInCommand) {
+    // Ends on '\n' only - a '\r' left behind would start a bogus frame
+    if (b == '\n') {
+      trainerCommand[trainerCommandLength] = '\0';
+      trainerInCommand = false;
+      handleSerialCommand(trainerCommand);
+    } else if (b != '\r' && trainerCommandLength < TRAINER_COMMAND_SIZE - 1) {
+      trainerCommand[trainerCommandLength++] = b;
+    }
+    return;
+  }
+
+  if (b == 0) {
+    endTrainerFrame();
+    return;
+  }
+
+  // '#' where a frame would start opens a console command
+  if (b == '#' && trainerBlockCode == 0) {
+    trainerInCommand = true;
+    trainerCommandLength = 0;
+    return;
+  }
+
+  if (trainerBlockRemaining == 0) {
+    // Code byte - every block but a full (0xFF) one ends in an encoded zero
+    if (trainerBlockCode != 0 && trainerBlockCode != 0xFF) appendTrainerByte(0);
+    trainerBlockCode = b;
+    trainerBlockRemaining = b - 1;
+  } else {
+    appendTrainerByte(b);
+    trainerBlockRemaining--;
+  }
+}
+
+void appendTrainerByte(uint8_t b) {
+  if (trainerLength >= TRAINER_BUFFER_SIZE) {
+    trainerOverflow = true;
+    return;
+  }
+  trainerBuffer[trainerLength++] = b;
+}
+
+void endTrainerFrame() {
+  // The zero after the last block is implied by the delimiter, not data
+  if (trainerBlockCode != 0) {
+    if (trainerOverflow || trainerBlockRemaining != 0 ||
+        !decodeTrainerFrame(trainerBuffer, trainerLength)) {
+      trainerErrors++;
+    }
+  }
+  trainerLength = 0;
+  trainerBlockRemaining = 0;
+  trainerBlockCode = 0;
+  trainerOverflow = false;
+}
+
+bool decodeTrainerFrame(const uint8_t* frame, uint8_t length) {
+  if (!SERIAL_TRAINER) return false;
+  if (length != TRAINER_FRAME_SIZE || frame[0] != TRAINER_FRAME_CHANNELS) return false;
+  if (crc8(frame, length - 1) != frame[length - 1]) return false;
+
+  uint8_t sequence = frame[1];
+  if (trainerFrames > 0) trainerLost += (uint8_t)(sequence - trainerLastSequence - 1);
+  trainerLastSequence = sequence;
+
+  // The control ISR (control_isr.h) may read them at any time - one frame, never a mix
+  noInterrupts();
+  for (uint8_t i = 0; i < RC_CHANNEL_COUNT; i++) {
+    int16_t value = (int16_t)(frame[2 + i * 2] | (frame[3 + i * 2] << 8));
+    trainerChannels[i] = constrain(value, -1000, 1000);
+  }
+  interrupts();
+
+  trainerFrames++;
+  trainerRateCount++;
+  lastTrainerFrame = millis();
+  if (!trainerActive) {
+    trainerActive = true;
+    Serial.println("Trainer input active - sticks overridden");
+  }
+  return true;
+}
+
+void handleSerialCommand(const char* command) {
+  if (strcmp(command, "status") == 0) {
+    if (!startConsoleDump(printStatusSection)) Serial.println("Console busy - try again");
+  } else if (strcmp(command, "trainer") == 0) {
+    if (!startConsoleDump(printTrainerSection)) Serial.println("Console busy - try again");
+  } else if (strcmp(command, "sched") == 0) {
+    if (!startConsoleDump(printSchedulerSection)) Serial.println("Console busy - try again");
+  } else if (strcmp(command, "prof") == 0 || strcmp(command, "prof reset") == 0) {
+#if PROFILER
+    if (command[4] != '\0') {
+      resetProfile();
+    } else if (!startConsoleDump(printProfileSection)) {
+      Serial.println("Console busy - try again");
+    }
+#else
+    Serial.println("Profiler not built (PROFILER 0)");
+#endif
+  } else if (strcmp(command, "trace") == 0 || strcmp(command, "trace clear") == 0) {
+#if TRACE
+    if (command[5] != '\0') {
+      clearTrace();
+    } else if (!startConsoleDump(printTraceSection)) {
+      Serial.println("Console busy - try again");
+    }
+#else
+    Serial.println("Trace not built (TRACE 0)");
+#endif
+  } else {
+    Serial.print("Unknown command: #");
+    Serial.println(command);
+  }
+}
+
+bool startConsoleDump(ConsoleSource source) {
+  if (consoleSource != NULL) return false;
+  consoleSource = source;
+  consoleSection = 0;
+  consoleLine.length = 0;
+  consoleLine.sent = 0;
+  return true;
+}
+
+void updateConsole() {
+  // Fills the TX buffer as far as it has room - Serial.write() never blocks here
+  while (consoleSource != NULL) {
+    if (consoleLine.sent == consoleLine.length) {
+      consoleLine.length = 0;
+      consoleLine.sent = 0;
+      if (!consoleSource(consoleLine, consoleSection++)) consoleSource = NULL;
+      continue;
+    }
+    int room = Serial.availableForWrite();
+    if (room <= 0) return;
+    uint8_t n = min(room, consoleLine.length - consoleLine.sent);
+    Serial.write(consoleLine.text + consoleLine.sent, n);
+    consoleLine.sent += n;
+  }
+}
+
+bool isConsoleBusy() {
+  return consoleSource != NULL;
+}
+
+void applyTrainerInput() {
+  // Same contract as readJoysticks() - stick channels only pass while ARMED,
+  // decided and stored atomically against the fast disarm ISR
+  noInterrupts();
+  for (uint8_t i = 0; i < RC_CHANNEL_COUNT; i++) {
+    channels[i] = trainerChannels[i];
+  }
+  if (!isArmed) {
+    channels[CH_STEERING] = 0;
+    channels[CH_THROTTLE] = 0;
+    channels[CH_RIGHT_JOY_Y] = 0;
+    channels[CH_LEFT_JOY_X] = 0;
+  }
+  data.steering = channels[CH_STEERING];
+  data.throttle = channels[CH_THROTTLE];
+  interrupts();
+}
+
+bool isTrainerActive() {
+  return SERIAL_TRAINER && trainerActive;
+}
+
+void printTrainerStats(Print &out) {
+  out.print("Trainer: "); out.print(trainerActive ? "active" : "idle");
+  out.print(", "); out.print(trainerRate); out.print(" frames/s, ");
+  out.print(trainerFrames); out.print(" good, ");
+  out.print(trainerErrors); out.print(" errors, ");
+  out.print(trainerLost); out.print(" lost, ");
+  out.print(trainerTimeouts); out.println(" timeouts");
+}
+
+bool printTrainerSection(Print &out, uint16_t section) {
+  // Console dump source - the statistics line is the only section
+  if (section > 0) return false;
+  printTrainerStats(out);
+  return true;
+}
+
+#endif
@@ -0,0 +1,87 @@
+/*
+  subframes.h - Channel priority subframes
+  RC Transmitter for Arduino Mega
+
+  With RADIO_SUBFRAMES the critical channels (steering and throttle, the
+  first RC_SUBFRAME_CRITICAL channels) go in every frame, while the slow
+  aux channels (other joystick axes, pots, triggers) rotate through groups
+  of RADIO_SUBFRAME_GROUP channels, one group per frame. Layout of a
+  subframe is documented in rc_packet.h.
+
+  Refresh guarantee: each slot has its own rotation, so every aux channel
+  is sent at least once every getRCSubframeGroups() frames of its slot.
+  Below RADIO_SUBFRAME_MIN_RATE full frames are sent instead, since airtime
+  does not matter there and a short cycle would stretch the refresh. An
+  aux channel is therefore never older than
+  groups / RADIO_SUBFRAME_MIN_RATE or one frame interval, whichever is
+  longer (plus lost frames, as for any channel).
+
+  Redundancy frames cover the full channel section, so subframes cannot be
+  combined with RADIO_REDUNDANCY.
+*/
+
+#ifndef SUBFRAMES_H
+#define SUBFRAMES_H
+
+#include "config.h"
+#include "rc_packet.h"
+#include "tdma.h"
+
+#if RADIO_SUBFRAMES && RADIO_PACKET_FORMAT != PACKET_FORMAT_PACKED
+#error "RADIO_SUBFRAMES needs RADIO_PACKET_FORMAT PACKET_FORMAT_PACKED"
+#endif
+#if RADIO_SUBFRAMES && RADIO_REDUNDANCY != REDUNDANCY_OFF
+#error "RADIO_SUBFRAMES cannot be combined with RADIO_REDUNDANCY"
+#endif
+#if RADIO_SUBFRAME_GROUP < 1 || RADIO_SUBFRAME_GROUP > 16
+#error "RADIO_SUBFRAME_GROUP must be 1-16"
+#endif
+
+// Next aux group per slot
+uint8_t subframeGroup[TDMA_MAX_SLOTS];
+uint32_t subframesSent = 0;
+
+// Forward declare rate getter
+extern int getCurrentPacketRate();
+
+// Function declarations
+void resetSubframes();
+bool isSubframeActive();
+uint8_t encodeScheduledPacket(uint8_t* buffer, uint8_t sequence, uint8_t slot, const int16_t* channels);
+uint8_t getSubframeGroups();
+unsigned long getAuxRefreshMillis();
+
+void resetSubframes() {
+  memset(subframeGroup, 0, sizeof(subframeGroup));
+  subframesSent = 0;
+}
+
+bool isSubframeActive() {
+  return RADIO_SUBFRAMES && RC_CHANNEL_COUNT > RC_SUBFRAME_CRITICAL &&
+         getCurrentPacketRate() >= RADIO_SUBFRAME_MIN_RATE;
+}
+
+uint8_t encodeScheduledPacket(uint8_t* buffer, uint8_t sequence, uint8_t slot, const int16_t* channels) {
+  if (!isSubframeActive()) {
+    return encodeRedundantPacket(buffer, sequence, slot, channels);
+  }
+
+  uint8_t group = subframeGroup[slot];
+  subframeGroup[slot] = (group + 1) % getSubframeGroups();
+  subframesSent++;
+  return encodeRCSubframe(buffer, sequence, channels, RC_CHANNEL_COUNT, RADIO_SUBFRAME_GROUP, group);
+}
+
+uint8_t getSubframeGroups() {
+  return getRCSubframeGroups(RC_CHANNEL_COUNT, RADIO_SUBFRAME_GROUP);
+}
+
+unsigned long getAuxRefreshMillis() {
+  // Worst-case age of an aux channel at the current rate, per slot
+  int rate = getCurrentPacketRate();
+  if (rate <= 0) return 0;
+  uint8_t frames = isSubframeActive() ? getSubframeGroups() : 1;
+  return 1000UL * frames / rate;
+}
+
+#endif
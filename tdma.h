@@ -0,0 +1,83 @@
+/*
+  tdma.h - Time-slotted transmission to several receivers
+  RC Transmitter for Arduino Mega
+
+  With SettingsData::tdmaSlots > 1 every transmit tick serves the next slot
+  in a fixed round robin, so one transmitter drives up to TDMA_MAX_SLOTS
+  boats. Each slot has its own address, sequence counter and channel mix.
+
+  Slot contract (receiver side):
+  - Slot 0 uses the bound address. Slot N uses the same address with the
+    last character advanced N places in A-Z0-9 (see makeSlotAddress), so a
+    receiver only needs to know its slot number.
+  - Each slot has its own counter, so loss is measured per boat exactly as
+    with a single receiver.
+  - All slots share one fixed channel - hopping is disabled while TDMA is
+    on, because the hop sequence follows a single counter.
+
+  Timing: the tick rate is the packet rate times the number of slots, but
+  never faster than TDMA_MIN_SLOT_MICROS. The slot index advances every
+  tick even when a frame has to be skipped, so each boat is guaranteed an
+  update at least every 2 * slots ticks.
+*/
+
+#ifndef TDMA_H
+#define TDMA_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// TDMA constants
+#define TDMA_MAX_SLOTS 4
+#define TDMA_MIN_SLOT_MICROS 1000   // Shortest slot - airtime, ACK and an address switch
+
+// What each slot sends
+enum TdmaMix {
+  TDMA_MIX_MAIN,      // Steering / throttle sticks
+  TDMA_MIX_AUX,       // Left joystick X / right joystick Y as steering / throttle
+  TDMA_MIX_NEUTRAL,   // Centred controls - keeps the boat stopped with a live link
+  TDMA_MIX_COUNT
+};
+
+// Function declarations
+void makeSlotAddress(const char* base, uint8_t slot, char* address);
+void mixSlotChannels(uint8_t mix, const int16_t* in, int16_t* out);
+const char* getTdmaMixName(uint8_t mix);
+
+void makeSlotAddress(const char* base, uint8_t slot, char* address) {
+  // Same character set as the address keyboard and the bind address
+  static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+  memcpy(address, base, 5);
+  address[5] = '\0';
+  if (slot == 0) return;
+
+  const char* pos = strchr(chars, address[4]);
+  uint8_t index = pos ? pos - chars : 0;
+  address[4] = chars[(index + slot) % 36];
+}
+
+void mixSlotChannels(uint8_t mix, const int16_t* in, int16_t* out) {
+  memcpy(out, in, RC_CHANNEL_COUNT * sizeof(int16_t));
+
+  switch (mix) {
+    case TDMA_MIX_AUX:
+      out[CH_STEERING] = in[CH_LEFT_JOY_X];
+      out[CH_THROTTLE] = in[CH_RIGHT_JOY_Y];
+      break;
+    case TDMA_MIX_NEUTRAL:
+      memset(out, 0, RC_CHANNEL_COUNT * sizeof(int16_t));
+      break;
+    default:
+      break;
+  }
+}
+
+const char* getTdmaMixName(uint8_t mix) {
+  switch (mix) {
+    case TDMA_MIX_AUX: return "AUX";
+    case TDMA_MIX_NEUTRAL: return "STOP";
+    default: return "MAIN";
+  }
+}
+
+#endif
@@ -0,0 +1,42 @@
+/*
+  Arduino.h - Host stand-in for the Arduino core
+  RC Transmitter for Arduino Mega
+
+  Just enough of the core for the headers the host tests pull in through
+  config.h: fixed-width types, micros() (defined by the test, which runs
+  its own clock) and a Print / Serial that writes to stdout. Found before
+  the real core only because the tests build with -I. first.
+*/
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+unsigned long micros();
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t b) = 0;
+  size_t print(const char* s) { size_t n = 0; while (*s) n += write((uint8_t)*s++); return n; }
+  size_t print(long v) { char s[24]; snprintf(s, sizeof(s), "%ld", v); return print(s); }
+  size_t print(unsigned long v) { char s[24]; snprintf(s, sizeof(s), "%lu", v); return print(s); }
+  size_t print(int v) { return print((long)v); }
+  size_t print(unsigned int v) { return print((unsigned long)v); }
+  size_t print(double v, int digits = 2) { char s[32]; snprintf(s, sizeof(s), "%.*f", digits, v); return print(s); }
+  template <typename T> size_t println(T v) { return print(v) + println(); }
+  size_t println() { return print("\r\n"); }
+};
+
+class HostSerial : public Print {
+public:
+  size_t write(uint8_t b) { return putchar(b) == EOF ? 0 : 1; }
+};
+
+static HostSerial Serial;
+
+#endif
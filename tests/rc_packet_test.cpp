@@ -0,0 +1,325 @@
+/*
+  rc_packet_test.cpp - Host round-trip test for rc_packet.h
+  RC Transmitter for Arduino Mega
+
+  rc_packet.h only needs <stdint.h>/<string.h>, so the encoder and decoder
+  are compiled and run on the PC here. Covers the CRC, bit packing, every
+  frame type (channels, delta, parity, subframe), the link-config and
+  timestamp trailers, and rejection of corrupted or foreign frames - and
+  the hop table from hopping.h, which the receiver builds the same way.
+
+  make -C tests      (or: g++ -std=c++11 -Wall -I.. rc_packet_test.cpp)
+
+  Lives outside the sketch folder root, so the Arduino IDE does not build it.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../rc_packet.h"
+#include "../hopping.h"
+
+#define NRF24_PAYLOAD 32
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(cond) do { \
+    checks++; \
+    if (!(cond)) { failures++; printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); } \
+  } while (0)
+
+static void fillChannels(int16_t* channels, uint8_t count, int seed) {
+  // Full range including both ends and the centre
+  for (uint8_t i = 0; i < count; i++) {
+    switch ((i + seed) % 4) {
+      case 0: channels[i] = -1000; break;
+      case 1: channels[i] = 1000; break;
+      case 2: channels[i] = 0; break;
+      default: channels[i] = (int16_t)((rand() % 2001) - 1000); break;
+    }
+  }
+}
+
+static bool sameChannels(const int16_t* a, const int16_t* b, uint8_t count) {
+  return memcmp(a, b, count * sizeof(int16_t)) == 0;
+}
+
+static void testCrc() {
+  // CRC-8/DVB-S2 check value
+  const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  CHECK(crc8(check, sizeof(check)) == 0xBC);
+  CHECK(crc8(check, 0) == 0);
+}
+
+static void testBitPacking() {
+  uint16_t values[RC_MAX_CHANNELS], unpacked[RC_MAX_CHANNELS];
+  uint8_t packed[RC_PACKET_MAX_SIZE];
+  for (uint8_t width = 1; width <= 12; width++) {
+    for (uint8_t i = 0; i < RC_MAX_CHANNELS; i++) values[i] = (uint16_t)(rand() & ((1 << width) - 1));
+    packBits(values, RC_MAX_CHANNELS, width, packed);
+    unpackBits(packed, RC_MAX_CHANNELS, width, unpacked);
+    CHECK(memcmp(values, unpacked, sizeof(values)) == 0);
+  }
+
+  // 11-bit LSB-first layout, as SBUS / CRSF
+  uint16_t two[2] = {0x7FF, 0x001};
+  packBits11(two, 2, packed);
+  CHECK(packed[0] == 0xFF && packed[1] == 0x0F && packed[2] == 0x00);
+}
+
+static void testChannelFrames() {
+  int16_t channels[RC_MAX_CHANNELS], decoded[RC_MAX_CHANNELS];
+  uint8_t buffer[RC_PACKET_MAX_SIZE];
+  uint8_t sequence, count;
+
+  for (uint8_t n = 1; n <= RC_MAX_CHANNELS; n++) {
+    fillChannels(channels, n, n);
+    uint8_t length = encodeRCPacket(buffer, n * 7, channels, n);
+    CHECK(length == getRCPacketSize(n));
+    CHECK(length <= RC_PACKET_MAX_SIZE);
+    CHECK(decodeRCPacket(buffer, length, sequence, decoded, count));
+    CHECK(sequence == (uint8_t)(n * 7));
+    CHECK(count == n);
+    CHECK(sameChannels(channels, decoded, n));
+  }
+
+  // Out-of-range values are clamped to the 11-bit field
+  int16_t extreme[2] = {3000, -3000};
+  uint8_t length = encodeRCPacket(buffer, 0, extreme, 2);
+  CHECK(decodeRCPacket(buffer, length, sequence, decoded, count));
+  CHECK(decoded[0] == 2047 - RC_CHANNEL_OFFSET && decoded[1] == -RC_CHANNEL_OFFSET);
+}
+
+static void testCorruption() {
+  int16_t channels[8], decoded[RC_MAX_CHANNELS];
+  uint8_t buffer[RC_PACKET_MAX_SIZE];
+  uint8_t sequence, count;
+  fillChannels(channels, 8, 0);
+  uint8_t length = encodeRCPacket(buffer, 1, channels, 8);
+
+  // Every single-bit error is caught
+  for (uint16_t bit = 0; bit < length * 8; bit++) {
+    buffer[bit >> 3] ^= (uint8_t)(1 << (bit & 7));
+    CHECK(!decodeRCPacket(buffer, length, sequence, decoded, count));
+    buffer[bit >> 3] ^= (uint8_t)(1 << (bit & 7));
+  }
+  CHECK(!decodeRCPacket(buffer, length - 1, sequence, decoded, count));
+
+  // Other versions and frame types are not channel frames
+  buffer[0] = ((RC_PACKET_VERSION + 1) << 4) | RC_FRAME_CHANNELS;
+  buffer[length - 1] = crc8(buffer, length - 1);
+  CHECK(!decodeRCPacket(buffer, length, sequence, decoded, count));
+  buffer[0] = (RC_PACKET_VERSION << 4) | RC_FRAME_PARITY;
+  buffer[length - 1] = crc8(buffer, length - 1);
+  CHECK(!decodeRCPacket(buffer, length, sequence, decoded, count));
+}
+
+static void testDeltaFrames() {
+  int16_t channels[8], previous[8], decoded[RC_MAX_CHANNELS], rebuilt[RC_MAX_CHANNELS];
+  uint8_t buffer[RC_PACKET_MAX_SIZE * 2];
+  uint8_t sequence, count;
+
+  for (int round = 0; round < 50; round++) {
+    fillChannels(previous, 8, round);
+    fillChannels(channels, 8, round + 1);
+    uint8_t length = encodeRCDeltaPacket(buffer, round, channels, previous, 8);
+    CHECK(length <= NRF24_PAYLOAD);
+    CHECK(decodeRCPacket(buffer, length, sequence, decoded, count));
+    CHECK(count == 8 && sameChannels(channels, decoded, 8));
+    CHECK(decodeRCPrevious(buffer, length, rebuilt));
+    CHECK(sameChannels(previous, rebuilt, 8));
+  }
+
+  // Unchanged channels need a zero-width delta block
+  fillChannels(channels, 8, 3);
+  uint8_t length = encodeRCDeltaPacket(buffer, 9, channels, channels, 8);
+  CHECK(length == getRCPacketSize(8) + 1);
+  CHECK(buffer[getRCPacketSize(8) - 1] == 0);
+  CHECK(decodeRCPrevious(buffer, length, rebuilt));
+  CHECK(sameChannels(channels, rebuilt, 8));
+
+  // A full frame has no previous values to give
+  length = encodeRCPacket(buffer, 9, channels, 8);
+  CHECK(!decodeRCPrevious(buffer, length, rebuilt));
+}
+
+static void testParityFrames() {
+  const uint8_t group = 4, n = 8;
+  int16_t frames[group][n], decoded[RC_MAX_CHANNELS];
+  uint8_t packets[group][RC_PACKET_MAX_SIZE * 2];
+  uint8_t parity[RC_PACKET_MAX_SIZE], buffer[RC_PACKET_MAX_SIZE];
+
+  // Mixed full and delta frames - channel bytes sit at the same offset
+  memset(parity, 0, sizeof(parity));
+  for (uint8_t f = 0; f < group; f++) {
+    fillChannels(frames[f], n, f);
+    if (f % 2) {
+      encodeRCDeltaPacket(packets[f], f, frames[f], frames[f - 1], n);
+    } else {
+      encodeRCPacket(packets[f], f, frames[f], n);
+    }
+    accumulateRCParity(parity, packets[f], n);
+  }
+  uint8_t length = encodeRCParityPacket(buffer, group - 1, parity, n, group);
+  CHECK(length == getRCPacketSize(n));
+
+  // Any one lost frame is rebuilt from the parity and the others
+  for (uint8_t lost = 0; lost < group; lost++) {
+    uint8_t received[RC_PACKET_MAX_SIZE];
+    memset(received, 0, sizeof(received));
+    for (uint8_t f = 0; f < group; f++) {
+      if (f != lost) accumulateRCParity(received, packets[f], n);
+    }
+    uint8_t lastSequence, decodedGroup, count;
+    CHECK(decodeRCParityPacket(buffer, length, received, lastSequence, decodedGroup, decoded, count));
+    CHECK(lastSequence == group - 1 && decodedGroup == group && count == n);
+    CHECK(sameChannels(frames[lost], decoded, n));
+  }
+
+  buffer[RC_PACKET_HEADER_SIZE] ^= 0x01;
+  uint8_t lastSequence, decodedGroup, count;
+  CHECK(!decodeRCParityPacket(buffer, length, parity, lastSequence, decodedGroup, decoded, count));
+}
+
+static void testSubframes() {
+  // 8 channels in groups of 2, then 7 and 16 channels with a short last group
+  const uint8_t counts[] = {8, 7, RC_MAX_CHANNELS};
+  const uint8_t sizes[] = {2, 2, 3};
+  for (uint8_t t = 0; t < 3; t++) {
+    uint8_t n = counts[t], size = sizes[t];
+    int16_t channels[RC_MAX_CHANNELS], state[RC_MAX_CHANNELS];
+    uint8_t buffer[RC_PACKET_MAX_SIZE];
+    fillChannels(channels, n, t);
+    for (uint8_t i = 0; i < n; i++) state[i] = 12345;
+
+    uint8_t groups = getRCSubframeGroups(n, size);
+    CHECK(groups == (n - RC_SUBFRAME_CRITICAL + size - 1) / size);
+    for (uint8_t g = 0; g < groups; g++) {
+      uint8_t length = encodeRCSubframe(buffer, g, channels, n, size, g);
+      CHECK(length == RC_SUBFRAME_HEADER_SIZE + getRCChannelBytes(RC_SUBFRAME_CRITICAL + getRCSubframeAuxCount(n, size, g)) + 1);
+      uint8_t sequence, count;
+      CHECK(decodeRCSubframe(buffer, length, sequence, state, count));
+      CHECK(sequence == g && count == n);
+      // Critical channels arrive with every group
+      CHECK(sameChannels(channels, state, RC_SUBFRAME_CRITICAL));
+    }
+    CHECK(sameChannels(channels, state, n));
+
+    // Subframes are not full channel frames and vice versa
+    uint8_t length = encodeRCSubframe(buffer, 0, channels, n, size, 0);
+    int16_t decoded[RC_MAX_CHANNELS];
+    uint8_t sequence, count;
+    CHECK(!decodeRCPacket(buffer, length, sequence, decoded, count));
+    length = encodeRCPacket(buffer, 0, channels, n);
+    CHECK(!decodeRCSubframe(buffer, length, sequence, decoded, count));
+  }
+}
+
+static void testTrailers() {
+  int16_t channels[8], previous[8], decoded[RC_MAX_CHANNELS];
+  uint8_t buffer[RC_PACKET_MAX_SIZE * 2];
+  uint8_t sequence, count, dataRate, switchSequence;
+  uint32_t timestamp;
+  fillChannels(channels, 8, 1);
+  fillChannels(previous, 8, 2);
+
+  // Channel frame with each trailer alone and both together
+  uint8_t length = encodeRCPacket(buffer, 5, channels, 8);
+  CHECK(!getRCTimestamp(buffer, length, timestamp));
+  CHECK(!getRCLinkConfig(buffer, length, dataRate, switchSequence));
+  length = appendRCTimestamp(buffer, length, 0x89ABCDEFUL);
+  CHECK(decodeRCPacket(buffer, length, sequence, decoded, count));
+  CHECK(sameChannels(channels, decoded, 8));
+  CHECK(getRCTimestamp(buffer, length, timestamp) && timestamp == 0x89ABCDEFUL);
+  CHECK(!getRCLinkConfig(buffer, length, dataRate, switchSequence));
+
+  length = encodeRCPacket(buffer, 5, channels, 8);
+  length = appendRCLinkConfig(buffer, length, 2, 77);
+  CHECK(decodeRCPacket(buffer, length, sequence, decoded, count));
+  CHECK(getRCLinkConfig(buffer, length, dataRate, switchSequence));
+  CHECK(dataRate == 2 && switchSequence == 77);
+  CHECK(!getRCTimestamp(buffer, length, timestamp));
+
+  // Widest delta block plus an announcement still fits the nRF24 payload
+  // (buildTxPayload() leaves the timestamp out when it would not)
+  int16_t low[8], high[8];
+  for (uint8_t i = 0; i < 8; i++) { low[i] = -1000; high[i] = 1000; }
+  length = encodeRCDeltaPacket(buffer, 6, high, low, 8);
+  length = appendRCLinkConfig(buffer, length, 1, 200);
+  CHECK(length <= NRF24_PAYLOAD);
+
+  // Delta with both trailers
+  for (uint8_t i = 0; i < 8; i++) previous[i] = channels[i] + (i % 3) - 1;
+  length = encodeRCDeltaPacket(buffer, 6, channels, previous, 8);
+  length = appendRCLinkConfig(buffer, length, 1, 200);
+  length = appendRCTimestamp(buffer, length, 123456789UL);
+  CHECK(length <= NRF24_PAYLOAD);
+  CHECK(decodeRCPacket(buffer, length, sequence, decoded, count));
+  CHECK(sameChannels(channels, decoded, 8));
+  int16_t rebuilt[RC_MAX_CHANNELS];
+  CHECK(decodeRCPrevious(buffer, length, rebuilt));
+  CHECK(sameChannels(previous, rebuilt, 8));
+  CHECK(getRCLinkConfig(buffer, length, dataRate, switchSequence));
+  CHECK(dataRate == 1 && switchSequence == 200);
+  CHECK(getRCTimestamp(buffer, length, timestamp) && timestamp == 123456789UL);
+
+  // Subframe with a timestamp
+  int16_t state[RC_MAX_CHANNELS];
+  length = encodeRCSubframe(buffer, 7, channels, 8, 2, 1);
+  length = appendRCTimestamp(buffer, length, 42);
+  CHECK(decodeRCSubframe(buffer, length, sequence, state, count));
+  CHECK(sameChannels(channels, state, RC_SUBFRAME_CRITICAL));
+  CHECK(state[4] == channels[4] && state[5] == channels[5]);
+  CHECK(getRCTimestamp(buffer, length, timestamp) && timestamp == 42);
+
+  // A flag without its trailer bytes fails the length check
+  length = encodeRCPacket(buffer, 5, channels, 8);
+  buffer[2] |= RC_FLAG_TIMESTAMP;
+  buffer[length - 1] = crc8(buffer, length - 1);
+  CHECK(!decodeRCPacket(buffer, length, sequence, decoded, count));
+}
+
+static void testHopTable() {
+  // Every seed: no repeats, all channels in range, every consecutive pair
+  // spaced - including the wrap from the last entry back to the first
+  uint8_t table[HOP_TABLE_SIZE];
+  bool allGood = true;
+  for (uint32_t seed = 0; seed <= 0xFFFF; seed++) {
+    generateHopTable((uint16_t)seed, table);
+    for (uint8_t i = 0; i < HOP_TABLE_SIZE; i++) {
+      uint8_t next = table[(i + 1) % HOP_TABLE_SIZE];
+      if (table[i] < HOP_CHANNEL_MIN || table[i] >= HOP_CHANNEL_MIN + HOP_CHANNEL_SPAN) allGood = false;
+      if (abs((int)table[i] - (int)next) < HOP_MIN_SPACING) allGood = false;
+      for (uint8_t j = 0; j < i; j++) {
+        if (table[j] == table[i]) allGood = false;
+      }
+    }
+    if (!allGood) {
+      printf("hop table for seed 0x%04X breaks the spacing rule\n", (unsigned)seed);
+      break;
+    }
+  }
+  CHECK(allGood);
+
+  // The channel follows the counter, and the last entry hands over to the first
+  generateHopTable(0x5EED, table);
+  CHECK(getHopChannel(table, HOP_TABLE_SIZE * 4 - 1, 4) == table[HOP_TABLE_SIZE - 1]);
+  CHECK(getHopChannel(table, HOP_TABLE_SIZE * 4, 4) == table[0]);
+  CHECK(abs((int)table[HOP_TABLE_SIZE - 1] - (int)table[0]) >= HOP_MIN_SPACING);
+}
+
+int main() {
+  srand(1);
+  testCrc();
+  testBitPacking();
+  testChannelFrames();
+  testCorruption();
+  testDeltaFrames();
+  testParityFrames();
+  testSubframes();
+  testTrailers();
+  testHopTable();
+
+  printf("rc_packet: %d checks, %d failed\n", checks, failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,122 @@
+/*
+  scheduler_test.cpp - Host simulation of the scheduler.h deadline rule
+  RC Transmitter for Arduino Mega
+
+  Runs the real task table and runScheduler() against a simulated clock.
+  Every task takes its full budget on every run - the worst case - and
+  loop() itself costs LOOP_OVERHEAD per pass. At each packet rate where
+  input sampling plus the transmit fit in a frame interval, the radio
+  frame may start late by at most the largest budget, and only one task
+  that can never fit in the slack may run per frame. At the default rate
+  every task that comes due in the simulated time must still get to run.
+
+  make -C tests      (or: g++ -std=c++11 -Wall -I. -I.. scheduler_test.cpp)
+
+  Lives outside the sketch folder root, so the Arduino IDE does not build it.
+*/
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "../scheduler.h"
+
+#define LOOP_OVERHEAD 20              // us of loop() around each runScheduler()
+#define SIM_TIME 2000000UL            // us simulated per packet rate
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(cond) do { \
+    checks++; \
+    if (!(cond)) { failures++; printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); } \
+  } while (0)
+
+static unsigned long clockMicros = 0;
+static unsigned long lastFrameAt = 0;
+static uint8_t longRunsThisFrame = 0;
+static uint8_t worstLongRuns = 0;
+
+unsigned long micros() {
+  return clockMicros;
+}
+
+static void spend(uint8_t id) {
+  // A task run lasts exactly its budget
+  unsigned long slack = getRadioSlack(clockMicros);
+  if (id > TASK_RADIO && tasks[id].budget > slack) {
+    if (++longRunsThisFrame > worstLongRuns) worstLongRuns = longRunsThisFrame;
+  }
+  clockMicros += tasks[id].budget;
+}
+
+void taskInput() { spend(TASK_INPUT); }
+void taskRadio() { lastFrameAt = clockMicros; longRunsThisFrame = 0; spend(TASK_RADIO); }
+void taskHealth() { spend(TASK_HEALTH); }
+void taskMenu() { spend(TASK_MENU); }
+void taskDisplay() { spend(TASK_DISPLAY); }
+void taskDisplayPush() { spend(TASK_DISPLAY_PUSH); }
+void taskLEDs() { spend(TASK_LEDS); }
+void taskDebug() { spend(TASK_DEBUG); }
+void taskConsole() { spend(TASK_CONSOLE); }
+
+static unsigned long largestBudget() {
+  unsigned long largest = 0;
+  for (uint8_t i = 0; i < SCHED_TASKS; i++) {
+    if (tasks[i].budget > largest) largest = tasks[i].budget;
+  }
+  return largest;
+}
+
+static void simulate(unsigned long interval) {
+  for (uint8_t i = 0; i < SCHED_TASKS; i++) {
+    Task &t = tasks[i];
+    t.runs = t.overruns = t.deferred = 0;
+    t.worstMicros = t.worstLate = 0;
+    t.enabled = true; // Display push and console dump busy the whole time
+  }
+  setTaskPeriod(TASK_RADIO, interval);
+  worstLongRuns = 0;
+  initScheduler();
+
+  unsigned long start = clockMicros;
+  while (clockMicros - start < SIM_TIME) {
+    runScheduler();
+    clockMicros += LOOP_OVERHEAD;
+  }
+}
+
+static void testJitter() {
+  static const unsigned int rates[] = {50, 100, 200, 250, 333, 400};
+  unsigned long bound = largestBudget();
+  unsigned long frameWork = tasks[TASK_INPUT].budget + tasks[TASK_RADIO].budget + 2 * LOOP_OVERHEAD;
+
+  for (uint8_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+    unsigned long interval = 1000000UL / rates[r];
+    if (frameWork > interval) continue;
+    simulate(interval);
+
+    const Task &radio = tasks[TASK_RADIO];
+    printf("%3u Hz: %lu frames, radio late up to %lu us (bound %lu us)\n",
+           rates[r], (unsigned long)radio.runs, radio.worstLate, bound);
+    CHECK(radio.worstLate <= bound);
+    CHECK(worstLongRuns <= 1);
+    CHECK(radio.runs > 0);
+  }
+}
+
+static void testNoStarvation() {
+  // Default 50 Hz: every task due within the simulated time runs
+  simulate(20000);
+  for (uint8_t i = 0; i < SCHED_TASKS; i++) {
+    if (tasks[i].period >= SIM_TIME) continue;
+    if (tasks[i].runs == 0) printf("task %s never ran\n", tasks[i].name);
+    CHECK(tasks[i].runs > 0);
+  }
+  CHECK(tasks[TASK_RADIO].worstLate <= largestBudget());
+}
+
+int main() {
+  testJitter();
+  testNoStarvation();
+  printf("scheduler: %d checks, %d failed\n", checks, failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""Reference sender for serial_trainer.h - drives the transmitter from a PC.
+
+Sends COBS encoded channel frames on the USB serial port at a fixed rate.
+Without --channels it sweeps the steering and throttle channels with a slow
+sine so the link can be checked end to end. Needs pyserial.
+
+  python3 tools/serial_trainer.py /dev/ttyACM0 --rate 500
+  python3 tools/serial_trainer.py /dev/ttyACM0 --channels 0,300,0,0,0,0,0,0
+"""
+
+import argparse
+import math
+import struct
+import time
+
+import serial
+
+FRAME_CHANNELS = 0x01
+CHANNEL_COUNT = 8
+
+
+def crc8(data):
+    # CRC-8/DVB-S2, same as rc_packet.h crc8()
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0xD5) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray()
+    block = bytearray()
+    for byte in data:
+        if byte == 0:
+            out += bytes([len(block) + 1]) + block
+            block = bytearray()
+        else:
+            block.append(byte)
+            if len(block) == 254:
+                out += bytes([255]) + block
+                block = bytearray()
+    out += bytes([len(block) + 1]) + block
+    return bytes(out)
+
+
+def build_frame(sequence, channels):
+    body = struct.pack("<BB%dh" % CHANNEL_COUNT, FRAME_CHANNELS, sequence & 0xFF, *channels)
+    return cobs_encode(body + bytes([crc8(body)])) + b"\x00"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--rate", type=float, default=200.0, help="frames per second")
+    parser.add_argument("--channels", help="fixed comma separated values, -1000..1000")
+    args = parser.parse_args()
+
+    fixed = None
+    if args.channels:
+        fixed = [int(v) for v in args.channels.split(",")]
+        fixed = (fixed + [0] * CHANNEL_COUNT)[:CHANNEL_COUNT]
+
+    link = serial.Serial(args.port, args.baud, timeout=0)
+    interval = 1.0 / args.rate
+    sequence = 0
+    start = time.monotonic()
+    next_frame = start
+    try:
+        while True:
+            if fixed is None:
+                phase = (time.monotonic() - start) * 2 * math.pi / 4.0
+                channels = [0] * CHANNEL_COUNT
+                channels[0] = int(500 * math.sin(phase))
+                channels[1] = int(500 * math.cos(phase))
+            else:
+                channels = fixed
+            link.write(build_frame(sequence, channels))
+            sequence += 1
+
+            # Echo the transmitter's debug output
+            waiting = link.in_waiting
+            if waiting:
+                print(link.read(waiting).decode(errors="replace"), end="")
+
+            next_frame += interval
+            time.sleep(max(0.0, next_frame - time.monotonic()))
+    except KeyboardInterrupt:
+        link.write(b"#trainer\n")
+        time.sleep(0.2)
+        print(link.read(link.in_waiting).decode(errors="replace"), end="")
+
+
+if __name__ == "__main__":
+    main()
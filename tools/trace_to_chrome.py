@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""Converts a trace.h "#trace" dump into Chrome trace JSON.
+
+Reads a serial log holding one or more dumps (text between the
+"--- Trace: ..." and "--- Trace end ---" lines, anything else is ignored)
+and writes the last one as Chrome trace events, for chrome://tracing or
+ui.perfetto.dev. Each name prefix (radio, display, menu, eeprom) gets its
+own track. micros() wrap-around is undone, and an end whose begin was
+overwritten in the ring buffer, or a begin still open at the end, is
+dropped.
+
+  python3 tools/trace_to_chrome.py capture.txt -o trace.json
+  python3 tools/trace_to_chrome.py /dev/ttyACM0 --serial -o trace.json
+
+With --serial the dump is requested ("#trace") and read straight from the
+port, which needs pyserial.
+"""
+
+import argparse
+import json
+import sys
+
+BEGIN_MARK = "--- Trace:"
+END_MARK = "--- Trace end ---"
+PHASES = {"B": "B", "E": "E", "M": "i"}
+
+
+def read_dump(lines):
+    # Event lines of the last complete dump
+    dump, current = None, None
+    for line in lines:
+        line = line.strip()
+        if line.startswith(BEGIN_MARK):
+            current = []
+        elif line == END_MARK and current is not None:
+            dump, current = current, None
+        elif current is not None:
+            current.append(line)
+    return dump
+
+
+def parse_events(lines):
+    events = []
+    offset, last = 0, None
+    for line in lines:
+        fields = line.split()
+        if len(fields) != 3 or fields[1] not in PHASES:
+            continue
+        try:
+            time = int(fields[0])
+        except ValueError:
+            continue
+        # micros() wraps every 71.6 minutes
+        if last is not None and time + offset < last - 2**31:
+            offset += 2**32
+        last = time + offset
+        events.append((last, PHASES[fields[1]], fields[2]))
+    return events
+
+
+def to_chrome(events):
+    tracks = {}
+    open_events = {}
+    out = []
+    start = events[0][0] if events else 0
+    for time, phase, name in events:
+        track, _, label = name.partition(".")
+        tid = tracks.setdefault(track, len(tracks) + 1)
+        event = {"name": label or track, "ph": phase, "ts": time - start,
+                 "pid": 1, "tid": tid}
+        if phase == "B":
+            open_events.setdefault(tid, []).append((len(out), name))
+        elif phase == "E":
+            stack = open_events.get(tid)
+            if not stack or stack[-1][1] != name:
+                continue
+            stack.pop()
+        else:
+            event["s"] = "t"
+        out.append(event)
+
+    # Begins never closed would stretch to the end of the trace
+    unclosed = {index for stack in open_events.values() for index, _ in stack}
+    out = [event for index, event in enumerate(out) if index not in unclosed]
+
+    for track, tid in tracks.items():
+        out.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": tid,
+                    "args": {"name": track}})
+    return {"traceEvents": out, "displayTimeUnit": "ms"}
+
+
+def read_serial(port, baud, timeout):
+    import serial
+
+    with serial.Serial(port, baud, timeout=timeout) as link:
+        link.reset_input_buffer()
+        # Leading 0x00 ends any half-sent trainer frame so '#' starts a command
+        link.write(b"\x00#trace\n")
+        lines = []
+        while True:
+            line = link.readline()
+            if not line:
+                break
+            text = line.decode("ascii", "replace")
+            lines.append(text)
+            if text.strip() == END_MARK:
+                break
+        return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source", help="captured serial log, '-' for stdin, or a port with --serial")
+    parser.add_argument("-o", "--output", help="JSON file to write (default stdout)")
+    parser.add_argument("--serial", action="store_true", help="request the dump from a serial port")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=2.0, help="seconds without a line before giving up")
+    args = parser.parse_args()
+
+    if args.serial:
+        lines = read_serial(args.source, args.baud, args.timeout)
+    elif args.source == "-":
+        lines = sys.stdin.readlines()
+    else:
+        with open(args.source, encoding="ascii", errors="replace") as f:
+            lines = f.readlines()
+
+    dump = read_dump(lines)
+    if dump is None:
+        sys.exit("No complete trace dump found")
+    trace = to_chrome(parse_events(dump))
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+        print()
+    print("%d events" % sum(1 for e in trace["traceEvents"] if e["ph"] != "M"), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
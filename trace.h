@@ -0,0 +1,143 @@
+/*
+  trace.h - Event trace ring buffer
+  RC Transmitter for Arduino Mega
+
+  The profiler (profiler.h) shows how long sections take on the whole, not
+  when a single slow one happened or what it overlapped - a one-off 90 ms
+  gap from an EEPROM write in saveSettings() during a display push only
+  shows as one count in a histogram. The trace keeps the last TRACE_EVENTS
+  timestamped begin / end / mark events in RAM, overwriting the oldest,
+  so such a hiccup can be looked at in order after the fact.
+
+  Emit points:
+  - radio.h: transmitData(), applyRadioConfig(), the fast disarm burst
+  - display.h: updateDisplay() drawing, each display push chunk
+  - menu.h: updateMenu()
+  - menu_data.h: saveSettings() / saveCalibration() EEPROM writes
+  Events can come from the control ISR and the fast disarm ISR as well,
+  so recording is atomic and keeps the caller's interrupt state.
+
+  Output: "#trace" on the serial console dumps the buffer oldest first,
+  one "<micros> <B|E|M> <track>.<name>" line per event, between a header
+  and a "--- Trace end ---" line. It is a console dump (serial_trainer.h):
+  one line per section, sent as the Serial TX buffer drains, so it never
+  holds up loop() - about 0.3 s for a full buffer at 115200 baud, during
+  which recording pauses. "#trace clear" empties the buffer.
+  tools/trace_to_chrome.py turns a captured dump into Chrome trace JSON
+  for chrome://tracing or ui.perfetto.dev, one track per name prefix.
+
+  Each event costs a micros() call and a few stores (about 5 us) and 5
+  bytes of RAM. With TRACE 0 in config.h the TRACE_* macros expand to
+  nothing and no trace state or code is built.
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "config.h"
+
+// Traced events - names below, same order
+enum TraceId {
+  TRACE_TRANSMIT,         // transmitData()
+  TRACE_RECONFIG,         // applyRadioConfig()
+  TRACE_DISARM,           // Fast disarm neutral burst (mark)
+  TRACE_DISPLAY_DRAW,     // updateDisplay() - drawing into the buffer
+  TRACE_DISPLAY_PUSH,     // One display push chunk
+  TRACE_MENU,             // updateMenu()
+  TRACE_SAVE_SETTINGS,    // saveSettings() EEPROM write
+  TRACE_SAVE_CALIBRATION, // saveCalibration() EEPROM write
+  TRACE_IDS
+};
+
+#if TRACE
+
+#define TRACE_EVENTS 128              // Power of two, at most 256
+#define TRACE_PHASE_BEGIN 0
+#define TRACE_PHASE_END 1
+#define TRACE_PHASE_MARK 2
+
+#define TRACE_BEGIN(id) recordTrace(id, TRACE_PHASE_BEGIN)
+#define TRACE_END(id) recordTrace(id, TRACE_PHASE_END)
+#define TRACE_MARK(id) recordTrace(id, TRACE_PHASE_MARK)
+
+struct TraceEvent {
+  uint32_t time;                      // micros()
+  uint8_t code;                       // id << 2 | phase
+};
+
+const char* const traceNames[TRACE_IDS] = {
+  "radio.transmit", "radio.reconfig", "radio.disarm", "display.draw",
+  "display.push", "menu.update", "eeprom.settings", "eeprom.calibration"
+};
+
+TraceEvent traceEvents[TRACE_EVENTS];
+uint8_t traceHead = 0;                // Next slot to write
+uint32_t traceRecorded = 0;           // Events since the last clear
+volatile bool tracePaused = false;    // A dump is running
+uint16_t traceDumpCount = 0;
+uint8_t traceDumpStart = 0;
+
+// Function declarations
+void recordTrace(uint8_t id, uint8_t phase);
+void clearTrace();
+bool printTraceSection(Print &out, uint16_t section);
+
+void recordTrace(uint8_t id, uint8_t phase) {
+  if (tracePaused) return;
+  uint32_t now = micros();
+  // Saved and restored rather than interrupts() - this also runs inside ISRs
+  uint8_t sreg = SREG;
+  cli();
+  TraceEvent &e = traceEvents[traceHead];
+  e.time = now;
+  e.code = id << 2 | phase;
+  traceHead = (traceHead + 1) & (TRACE_EVENTS - 1);
+  traceRecorded++;
+  SREG = sreg;
+}
+
+void clearTrace() {
+  if (tracePaused) {
+    Serial.println("Trace dump running - not cleared");
+    return;
+  }
+  noInterrupts();
+  traceHead = 0;
+  traceRecorded = 0;
+  interrupts();
+  Serial.println("Trace cleared");
+}
+
+bool printTraceSection(Print &out, uint16_t section) {
+  // Console dump source - header, one event per section, end line
+  if (section == 0) {
+    tracePaused = true;
+    traceDumpCount = traceRecorded < TRACE_EVENTS ? traceRecorded : TRACE_EVENTS;
+    traceDumpStart = (traceHead - traceDumpCount) & (TRACE_EVENTS - 1);
+    out.print("--- Trace: "); out.print(traceDumpCount);
+    out.print(" events, "); out.print(traceRecorded - traceDumpCount);
+    out.println(" overwritten ---");
+  } else if (section <= traceDumpCount) {
+    const TraceEvent &e = traceEvents[(traceDumpStart + section - 1) & (TRACE_EVENTS - 1)];
+    uint8_t phase = e.code & 0x03;
+    out.print(e.time);
+    out.print(phase == TRACE_PHASE_BEGIN ? " B " : phase == TRACE_PHASE_END ? " E " : " M ");
+    out.println(traceNames[e.code >> 2]);
+  } else if (section == traceDumpCount + 1) {
+    out.println("--- Trace end ---");
+    tracePaused = false;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+#else
+
+#define TRACE_BEGIN(id)
+#define TRACE_END(id)
+#define TRACE_MARK(id)
+
+#endif
+
+#endif